@@ -0,0 +1,129 @@
+// Замер выделений памяти без Qt: сколько раз вызывается operator new при заполнении,
+// сохранении, загрузке и фильтрации N записей. Число выделений на проход должно расти
+// с числом записей не быстрее, чем число записей (буферы, результаты), а не с числом полей.
+// Сборка: cmake -DBUILD_BENCHMARKS=ON; запуск: AllocationBenchmark [N] [каталог]
+#include "librarysystem.h"
+#include "filemanager.h"
+#include "changetracker.h"
+#include "exceptions.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace {
+std::atomic<size_t> allocationCount{0};
+
+// Строка, дополненная пробелами до width символов (UTF-8: printf считает байты)
+std::string padded(std::string_view text, size_t width) {
+    size_t length = 0;
+    for (char c : text) {
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            ++length;
+        }
+    }
+    std::string result(text);
+    result.append(width > length ? width - length : 0, ' ');
+    return result;
+}
+
+// Выделения за время выполнения action
+template <typename Action>
+void measure(const char* name, size_t records, Action action) {
+    size_t before = allocationCount.load();
+    action();
+    size_t count = allocationCount.load() - before;
+    std::printf("%s %12zu %10.3f\n", padded(name, 30).c_str(), count, records ? static_cast<double>(count) / records : 0.0);
+}
+
+void fill(LibrarySystem& system, int bookCount) {
+    int memberCount = bookCount / 5 + 1;
+    system.beginBulkLoad(bookCount, memberCount, bookCount);
+    for (int id = 1; id <= bookCount; ++id) {
+        std::string number = std::to_string(id);
+        system.addBookWithId(id, "Книга " + number, "Автор " + std::to_string(id % 1000), "ISBN-" + number,
+                             1900 + id % 120, "Жанр " + std::to_string(id % 20), true, "", 3, "Описание книги " + number);
+    }
+    for (int id = 1; id <= memberCount; ++id) {
+        std::string number = std::to_string(id);
+        system.addMemberWithId(id, "Имя" + number, "Фамилия" + number, "+7 900 " + number, false, "user" + number + "@mail.ru");
+    }
+    system.addEmployeeWithId(1, "Анна", "Смирнова", "+7 901 000", 50000.0, 40, true);
+    Date today = Date::today();
+    for (int i = 0; i < bookCount; ++i) {
+        system.addBorrowedBook(i % memberCount + 1, i + 1, today.addDays(-40), today.addDays(-10), i % 4 != 0, 1);
+    }
+    system.endBulkLoad();
+}
+}
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char* argv[]) {
+    int count = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    std::string basePath = (argc > 2) ? argv[2]
+                                      : (std::filesystem::temp_directory_path() / "library-allocations").string();
+    if (count <= 0) {
+        std::cerr << "Использование: " << argv[0] << " [число книг] [каталог для файлов]\n";
+        return 2;
+    }
+    std::filesystem::remove_all(basePath);
+    std::filesystem::create_directories(basePath);
+
+    try {
+        LibrarySystem system;
+        std::printf("%s    Выделений   На книгу\n", padded("Проход", 30).c_str());
+        measure("Заполнение", count, [&] { fill(system, count); });
+
+        // Проход по полям, как при выводе таблиц: геттеры не должны копировать строки
+        size_t fieldBytes = 0;
+        measure("Чтение полей книг и абонентов", count, [&] {
+            for (const Book& book : system.getBooks()) {
+                fieldBytes += book.getTitle().size() + book.getAuthor().size() + book.getIsbn().size() +
+                              book.getGenre().size() + book.getDescription().size();
+            }
+            for (const LibraryMember& member : system.getMembers()) {
+                fieldBytes += member.getName().size() + member.getSurname().size() + member.getPhone().size() +
+                              member.getEmail().size();
+            }
+        });
+
+        CatalogColumns::Query query;
+        query.author = "автор 1";
+        size_t found = 0;
+        measure("Фильтр по автору", count, [&] { found = system.findBooks(query).size(); });
+        query = {};
+        query.text = "книга";
+        measure("Фильтр по словам", count, [&] { found += system.findBooks(query).size(); });
+
+        measure("Экспорт в текстовые файлы", count, [&] { FileManager::saveLibrarySystem(system, basePath); });
+        DirtyPartitions all;
+        all.all = true;
+        FileManager::Snapshot snapshot;
+        measure("Снимок контрольной точки", count, [&] { snapshot = FileManager::captureSnapshot(system, all); });
+        measure("Запись контрольной точки", count, [&] { FileManager::writeSnapshot(snapshot, basePath, 1); });
+
+        LibrarySystem loaded;
+        measure("Загрузка контрольной точки", count, [&] { FileManager::loadLibrarySystem(loaded, basePath); });
+
+        std::printf("\nКниг: %zu, найдено: %zu, байтов в полях: %zu\n", loaded.getBooks().size(), found, fieldBytes);
+    } catch (const LibraryException& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    std::filesystem::remove_all(basePath);
+    return 0;
+}
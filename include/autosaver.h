@@ -0,0 +1,66 @@
+#ifndef AUTOSAVER_H
+#define AUTOSAVER_H
+
+#include "filemanager.h"
+#include "journal.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Фоновое сохранение, чтобы интерфейс не ждал диска.
+// Обычные правки дописываются в журнал (append): пакеты, пришедшие, пока поток
+// занят, пишутся вместе - одной записью и одним fsync. Контрольная точка (submit, save)
+// переписывает изменённые сегменты и начинает журнал заново; ждущие пакеты, вошедшие
+// в снимок, отбрасываются, а ждущий снимок объединяется с более свежим. Снимок,
+// который не удалось записать, войдёт в следующий.
+class AutoSaver {
+public:
+    using ErrorHandler = std::function<void(const std::string&)>; // Вызывается из фонового потока
+
+private:
+    std::string basePath;
+    ErrorHandler onError;
+    Journal journal; // Только в фоновом потоке
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    std::condition_variable writeDone;
+    std::optional<FileManager::Snapshot> pending;
+    std::optional<FileManager::Snapshot> unwritten; // Не записан из-за ошибки
+    std::string pendingRecords; // Пакеты журнала после pending
+    bool writing = false;
+    bool stopping = false;
+    bool journalFailed = false; // Журнал неполон: нужна контрольная точка
+    std::atomic<size_t> journalBytes{0};
+    int flushWaiters = 0;
+    std::exception_ptr flushError; // Ошибка записи, которую получит save/sync, а не onError
+    std::thread worker; // Последним: поток запускается, когда остальные поля готовы
+
+    void run();
+    void write(const std::optional<FileManager::Snapshot>& snapshot, const std::string& records);
+    void wait(std::unique_lock<std::mutex>& lock);
+    void enqueue(FileManager::Snapshot snapshot); // Под блокировкой
+
+public:
+    AutoSaver(std::string_view pBasePath, ErrorHandler pOnError);
+    ~AutoSaver(); // Дописывает ждущие данные и останавливает поток
+    AutoSaver(const AutoSaver&) = delete;
+    AutoSaver& operator=(const AutoSaver&) = delete;
+
+    void append(std::string batch); // Пакет журнала (FileManager::captureJournalBatch), без ожидания
+    void submit(FileManager::Snapshot snapshot); // Контрольная точка в фоне, без ожидания
+    // Ожидание записи (ручное сохранение, закрытие окна): ошибка выбрасывается
+    // отсюда (FileException) и в onError уже не передаётся
+    void save(FileManager::Snapshot snapshot); // Контрольная точка
+    void sync(); // Всё, что уже передано
+
+    size_t journalSize() const { return journalBytes; } // Для решения, пора ли контрольная точка
+    bool needsCheckpoint(); // Запись журнала не удалась - изменения сохранит только снимок
+};
+
+#endif // AUTOSAVER_H
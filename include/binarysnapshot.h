@@ -0,0 +1,108 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include "mappedfile.h"
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class LibrarySystem;
+class Book;
+class LibraryMember;
+class Employee;
+
+// Двоичный снимок данных (library.bin). Файл читается через отображение в память:
+// числа лежат колонками фиксированной ширины, строки - в общем блоке с длиной перед
+// каждой строкой, поэтому любое поле любой записи доступно без разбора файла.
+//
+// Заголовок (HEADER_SIZE байт, порядок байтов - как у машины, записавшей файл):
+//   0  "LIBSNAP\0", версия, метка порядка байтов, число разделов,
+//      номер контрольной точки, nextBookId, nextEmployeeId, размер файла, CRC32 заголовка;
+//   64 таблица разделов: вид, CRC32 раздела, смещение, размер, число записей.
+// Раздел (смещение кратно 8): число записей и колонок, колонки int32, колонки double,
+// колонки смещений строк (uint32 от начала блока строк), блок строк "uint32 длина + байты".
+class BinarySnapshot {
+public:
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr size_t SECTION_COUNT = 4;
+    static constexpr size_t HEADER_SIZE = 64 + SECTION_COUNT * 32;
+
+    enum class Section : std::uint32_t { Books = 1, Members = 2, Loans = 3, Employees = 4 };
+
+    // Колонки разделов (номер колонки своего типа)
+    enum BookInt { BOOK_ID, BOOK_YEAR, BOOK_QUANTITY, BOOK_AVAILABLE, BOOK_DISABLED, BOOK_INTS };
+    enum BookText { BOOK_TITLE, BOOK_AUTHOR, BOOK_ISBN, BOOK_GENRE, BOOK_COVER, BOOK_DESCRIPTION, BOOK_PDF, BOOK_TEXTS };
+    enum MemberInt { MEMBER_ID, MEMBER_BLOCKED, MEMBER_INTS };
+    enum MemberText { MEMBER_NAME, MEMBER_SURNAME, MEMBER_PHONE, MEMBER_EMAIL, MEMBER_TEXTS };
+    enum LoanInt { LOAN_MEMBER, LOAN_BOOK, LOAN_BORROWED, LOAN_DUE, LOAN_RETURNED, LOAN_EMPLOYEE, LOAN_INTS }; // Даты - номера дней
+    enum EmployeeInt { EMPLOYEE_ID, EMPLOYEE_HOURS, EMPLOYEE_LIBRARIAN, EMPLOYEE_INTS };
+    enum EmployeeDouble { EMPLOYEE_SALARY, EMPLOYEE_DOUBLES };
+    enum EmployeeText { EMPLOYEE_NAME, EMPLOYEE_SURNAME, EMPLOYEE_PHONE, EMPLOYEE_TEXTS };
+
+    // Раздел внутри отображения: чтение полей без копирования
+    class Table {
+    private:
+        const char* ints = nullptr;
+        const char* doubles = nullptr;
+        const char* offsets = nullptr;
+        const char* strings = nullptr;
+        size_t stringsSize = 0;
+        size_t rows = 0;
+
+        friend class BinarySnapshot;
+
+    public:
+        size_t size() const { return rows; }
+
+        std::int32_t getInt(size_t column, size_t row) const {
+            std::int32_t value;
+            std::memcpy(&value, ints + (column * rows + row) * sizeof(value), sizeof(value));
+            return value;
+        }
+        double getDouble(size_t column, size_t row) const {
+            double value;
+            std::memcpy(&value, doubles + (column * rows + row) * sizeof(value), sizeof(value));
+            return value;
+        }
+        std::string_view getText(size_t column, size_t row) const; // DataException, если ссылка за пределами блока
+    };
+
+private:
+    MappedFile file;
+    std::string_view image;
+    std::int32_t checkpoint = 0;
+    std::int32_t nextBookId = 1;
+    std::int32_t nextEmployeeId = 1;
+
+    const char* sectionEntry(Section section) const;
+
+public:
+    // Файл, которого нет, не считается ошибкой: isOpen() == false.
+    // Заголовок проверяется сразу (DataException); содержимое разделов - в verify
+    explicit BinarySnapshot(const std::string& path);
+
+    bool isOpen() const { return file.isOpen(); }
+    void verify() const; // CRC всех разделов; DataException при повреждении
+    int getCheckpoint() const { return checkpoint; }
+    int getNextBookId() const { return nextBookId; }
+    int getNextEmployeeId() const { return nextEmployeeId; }
+    Table table(Section section) const;
+
+    // Записи, попадающие в образ
+    struct Contents {
+        std::vector<const Book*> books;
+        std::vector<const LibraryMember*> members; // Вместе с историей выдач
+        std::vector<const Employee*> employees;
+    };
+
+    // Образ файла в памяти (номер контрольной точки 0): все данные или только contents
+    static std::string capture(const LibrarySystem& system);
+    static std::string capture(const LibrarySystem& system, const Contents& contents);
+    // Номер контрольной точки в заголовке образа (header - первые HEADER_SIZE байт)
+    static void setCheckpoint(std::string& header, int pCheckpoint);
+};
+
+#endif // BINARYSNAPSHOT_H
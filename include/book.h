@@ -2,20 +2,32 @@
 #define BOOK_H
 
 #include "item.h"
+#include "internedstring.h"
 #include <string>
 #include <string_view>
+#include <memory>
 
-class Book : public Item {
-private:
-    std::string author;
-    std::string isbn;
-    int year;
-    std::string genre;
+// Редко читаемые поля книги (нужны карточке книги и диалогу редактирования)
+struct BookDetails {
     std::string coverPath; // Путь к обложке книги
-    int quantity; // Количество экземпляров книги
     std::string description; // Описание книги
     std::string pdfPath; // Путь к PDF файлу книги
+};
+
+class Book : public Item {
+private:
+    // Поля, которые читают фильтры, сортировки и проверки доступности
+    int year;
+    int totalCopies; // Всего экземпляров книги: в наличии и на руках
+    int activeLoans = 0; // Экземпляров на руках (поддерживается LibrarySystem при выдаче/возврате/загрузке)
     bool manuallyDisabled = false; // Ручная блокировка доступности (переопределяет автоматическую логику)
+    InternedString author;
+    InternedString genre;
+    std::string isbn;
+    std::unique_ptr<BookDetails> details; // nullptr, пока все редкие поля пустые
+
+    const BookDetails& getDetails() const;
+    BookDetails& editDetails(); // Создаёт запись при первой записи
 
 public:
     explicit Book(int pId, std::string_view pTitle, std::string_view pAuthor, 
@@ -23,25 +35,34 @@ public:
          std::string_view pCoverPath = "", int pQuantity = 1,
          std::string_view pDescription = "", std::string_view pPdfPath = "");
     
-    std::string getAuthor() const { return author; }
-    std::string getIsbn() const { return isbn; }
+    const std::string& getAuthor() const { return author.str(); }
+    InternedString getAuthorKey() const { return author; }
+    const std::string& getIsbn() const { return isbn; }
     int getYear() const { return year; }
-    std::string getGenre() const { return genre; }
-    std::string getCoverPath() const { return coverPath; }
-    int getQuantity() const { return quantity; }
-    std::string getDescription() const { return description; }
-    std::string getPdfPath() const { return pdfPath; }
+    const std::string& getGenre() const { return genre.str(); }
+    InternedString getGenreKey() const { return genre; }
+    const std::string& getCoverPath() const { return getDetails().coverPath; }
+    int getQuantity() const { return totalCopies - activeLoans; } // Экземпляры в наличии (как в файлах данных)
+    const std::string& getDescription() const { return getDetails().description; }
+    const std::string& getPdfPath() const { return getDetails().pdfPath; }
     
-    void setAuthor(std::string_view pAuthor) { author = pAuthor; }
+    void setAuthor(std::string_view pAuthor) { author = InternedString(pAuthor); }
     void setIsbn(std::string_view pIsbn) { isbn = pIsbn; }
     void setYear(int pYear) { year = pYear; }
-    void setGenre(std::string_view pGenre) { genre = pGenre; }
-    void setCoverPath(std::string_view pCoverPath) { coverPath = pCoverPath; }
-    void setQuantity(int pQuantity) { quantity = pQuantity; }
-    void setDescription(std::string_view pDescription) { description = pDescription; }
-    void setPdfPath(std::string_view pPdfPath) { pdfPath = pPdfPath; }
+    void setGenre(std::string_view pGenre) { genre = InternedString(pGenre); }
+    void setCoverPath(std::string_view pCoverPath);
+    void setQuantity(int pQuantity) { totalCopies = pQuantity + activeLoans; }
+    void setDescription(std::string_view pDescription);
+    void setPdfPath(std::string_view pPdfPath);
     bool getManuallyDisabled() const { return manuallyDisabled; }
     void setManuallyDisabled(bool disabled) { this->manuallyDisabled = disabled; }
+    int getActiveLoans() const { return activeLoans; }
+    // Число экземпляров на руках при неизменном числе в наличии (загрузка, отмена, удаление абонента)
+    void setActiveLoans(int pActiveLoans) { totalCopies += pActiveLoans - activeLoans; activeLoans = pActiveLoans; }
+    void lendCopy() { ++activeLoans; } // Выдача: экземпляр переходит с полки на руки
+    void returnCopy() { --activeLoans; } // Возврат: экземпляр возвращается на полку
+    int getTotalCopies() const { return totalCopies; }
+    bool canBeBorrowed() const { return !manuallyDisabled && activeLoans < totalCopies; }
     
     std::string getInfo() const override;
     std::string getType() const override { return "Book"; }
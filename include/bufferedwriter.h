@@ -0,0 +1,45 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include "date.h"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Запись текстового файла через собственный буфер большого размера.
+// Строки копируются в буфер как есть, числа и даты форматируются без iostream
+// (std::to_chars, Date::formatTo); в файл данные уходят блоками по BUFFER_SIZE.
+// Вместо файла можно писать в строку в памяти - тем же кодом форматирования.
+class BufferedWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+private:
+    std::string path;
+    std::ofstream file;
+    std::string* memory = nullptr; // Строка-приёмник вместо файла
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+
+    char* reserve(size_t count); // Место под count байт (count <= BUFFER_SIZE)
+    void flushBuffer();
+
+public:
+    explicit BufferedWriter(std::string_view pPath); // FileException, если файл не открылся
+    explicit BufferedWriter(std::string* target); // Дописывает в *target (указатель - чтобы путь в std::string не выбрал этот конструктор)
+    ~BufferedWriter(); // Остаток буфера записывается, если close не вызывался (ошибки игнорируются)
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    BufferedWriter& operator<<(std::string_view text);
+    BufferedWriter& operator<<(char c);
+    BufferedWriter& operator<<(int value);
+    BufferedWriter& operator<<(double value);
+    BufferedWriter& operator<<(Date date); // "YYYY-MM-DD", пустая дата - пустое поле
+
+    void close(); // Запись остатка и закрытие; FileException при ошибке записи
+};
+
+#endif // BUFFEREDWRITER_H
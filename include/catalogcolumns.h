@@ -0,0 +1,62 @@
+#ifndef CATALOGCOLUMNS_H
+#define CATALOGCOLUMNS_H
+
+#include "book.h"
+#include "substringcolumn.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Приведение к нижнему регистру для поиска: простые строчные пары Unicode (как QString::toLower) в UTF-8
+std::string foldCase(std::string_view text);
+
+// Поколоночная копия полей каталога, по которым фильтруется таблица книг.
+// Строка N соответствует слоту N в LibraryContainer. Год и доступность лежат
+// плотными массивами, поэтому фильтры по ним - простые циклы без обращения к Book;
+// подстроки в названии, авторе и ISBN ищутся по триграммам (SubstringColumn).
+class CatalogColumns {
+public:
+    struct Query {
+        std::string title; // Подстроки; пустая строка - без фильтра
+        std::string author;
+        std::string genre;
+        std::string isbn;
+        int yearFrom = 0; // 0 - без ограничения
+        int yearTo = 0;
+        int availability = -1; // -1 - все, 1 - доступные, 0 - недоступные
+        std::string text; // Слова из названия, автора, жанра или описания (TextIndex); пустая строка - без фильтра
+    };
+
+private:
+    using Word = SubstringColumn::Word;
+    static constexpr size_t WORD_BITS = SubstringColumn::WORD_BITS;
+
+    std::vector<int> years;
+    std::vector<Word> liveBits; // Строка занята книгой
+    std::vector<Word> availableBits;
+    SubstringColumn titles; // В нижнем регистре (foldCase)
+    SubstringColumn authors;
+    SubstringColumn isbns;
+    std::vector<InternedString> genres; // Значений немного: строка проверяется один раз на значение
+
+    static void setBit(std::vector<Word>& bits, size_t row, bool value);
+    void filterYears(std::vector<Word>& mask, int yearFrom, int yearTo) const;
+    static void filterInterned(std::vector<Word>& mask, const std::vector<InternedString>& column, std::string_view needle);
+
+public:
+    void append(const Book& book); // Новая строка в конце
+    void appendEmpty(); // Пустая строка в конце (место удалённой книги)
+    void update(size_t row, const Book& book);
+    void setAvailable(size_t row, bool available); // Только доступность: выдача и возврат не меняют остальные поля
+    void erase(size_t row); // Строка становится пустой, номера остальных не меняются
+    void clear();
+    void reserve(size_t count);
+    size_t size() const { return years.size(); }
+
+    // Номера подходящих строк по возрастанию; candidates - только среди этих строк (по возрастанию)
+    std::vector<size_t> select(const Query& query, const std::vector<size_t>* candidates = nullptr) const;
+};
+
+#endif // CATALOGCOLUMNS_H
@@ -0,0 +1,120 @@
+#ifndef CHANGETRACKER_H
+#define CHANGETRACKER_H
+
+#include "loanstore.h"
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Получатель уведомлений об изменениях данных LibrarySystem.
+// При массовой загрузке (beginBulkLoad/endBulkLoad) уведомления не приходят
+class ChangeListener {
+public:
+    virtual ~ChangeListener() = default;
+
+    virtual void bookChanged(int id) = 0; // Добавлена или изменена
+    virtual void bookRemoved(int id) = 0;
+    virtual void memberChanged(int id) = 0;
+    virtual void memberRemoved(int id) = 0;
+    virtual void employeeChanged(int id) = 0;
+    virtual void employeeRemoved(int id) = 0;
+    virtual void loanChanged(LoanStore::LoanId id, int memberId) = 0; // Выдача или возврат
+    virtual void loansRenumbered(const std::vector<LoanStore::LoanId>& newIds) = 0; // После LoanStore::compact()
+};
+
+// Разделы данных, изменённые после последней контрольной точки. Раздел - диапазон
+// из PARTITION_SIZE номеров записей одного вида; контрольная точка переписывает
+// только сегменты изменённых разделов (FileManager::captureSnapshot)
+struct DirtyPartitions {
+    static constexpr int PARTITION_SIZE = 10000;
+    static int partitionOf(int id) { return id / PARTITION_SIZE; }
+
+    bool all = false; // Все разделы, в том числе те, о которых уведомлений не было
+    std::set<int> books;
+    std::set<int> members; // Вместе с историей выдач абонентов
+    std::set<int> employees;
+};
+
+// Номера записей, изменённых после последней фиксации журнала.
+// Строки журнала формируются только при фиксации (FileManager::captureJournalBatch),
+// поэтому серия правок одной записи даёт в журнале одну строку
+class ChangeTracker : public ChangeListener {
+private:
+    DirtyPartitions dirty; // Копится до контрольной точки, clear() его не трогает
+
+public:
+    std::unordered_set<int> changedBooks;
+    std::unordered_set<int> removedBooks; // Удалённые хотя бы раз - даже если потом восстановлены отменой
+    std::unordered_set<int> changedMembers;
+    std::unordered_set<int> removedMembers;
+    std::unordered_set<int> changedEmployees;
+    std::unordered_set<int> removedEmployees;
+    std::vector<LoanStore::LoanId> changedLoans; // Возможны повторы
+
+    void bookChanged(int id) override {
+        changedBooks.insert(id);
+        dirty.books.insert(DirtyPartitions::partitionOf(id));
+    }
+    void bookRemoved(int id) override {
+        removedBooks.insert(id);
+        dirty.books.insert(DirtyPartitions::partitionOf(id));
+    }
+    void memberChanged(int id) override {
+        changedMembers.insert(id);
+        dirty.members.insert(DirtyPartitions::partitionOf(id));
+    }
+    void memberRemoved(int id) override {
+        removedMembers.insert(id);
+        dirty.members.insert(DirtyPartitions::partitionOf(id));
+    }
+    void employeeChanged(int id) override {
+        changedEmployees.insert(id);
+        dirty.employees.insert(DirtyPartitions::partitionOf(id));
+    }
+    void employeeRemoved(int id) override {
+        removedEmployees.insert(id);
+        dirty.employees.insert(DirtyPartitions::partitionOf(id));
+    }
+    void loanChanged(LoanStore::LoanId id, int memberId) override {
+        changedLoans.push_back(id);
+        dirty.members.insert(DirtyPartitions::partitionOf(memberId));
+    }
+    void loansRenumbered(const std::vector<LoanStore::LoanId>& newIds) override {
+        // Выдачи удалённых абонентов в журнал всё равно не попадают
+        std::vector<LoanStore::LoanId> renumbered;
+        renumbered.reserve(changedLoans.size());
+        for (LoanStore::LoanId id : changedLoans) {
+            if (newIds[id] != LoanStore::npos) {
+                renumbered.push_back(newIds[id]);
+            }
+        }
+        changedLoans = std::move(renumbered);
+    }
+
+    bool empty() const {
+        return changedBooks.empty() && removedBooks.empty() && changedMembers.empty() && removedMembers.empty() &&
+               changedEmployees.empty() && removedEmployees.empty() && changedLoans.empty();
+    }
+
+    void clear() {
+        changedBooks.clear();
+        removedBooks.clear();
+        changedMembers.clear();
+        removedMembers.clear();
+        changedEmployees.clear();
+        removedEmployees.clear();
+        changedLoans.clear();
+    }
+
+    // Данные менялись в обход уведомлений (загрузка, импорт) - следующая контрольная точка полная
+    void markAllDirty() { dirty.all = true; }
+    // Изменённые разделы для контрольной точки; накопление начинается заново
+    DirtyPartitions takeDirty() {
+        DirtyPartitions result = std::move(dirty);
+        dirty = DirtyPartitions();
+        return result;
+    }
+};
+
+#endif // CHANGETRACKER_H
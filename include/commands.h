@@ -6,6 +6,8 @@
 #include "book.h"
 #include "librarymember.h"
 #include "employee.h"
+#include "librarian.h"
+#include "internedstring.h"
 #include <string>
 #include <string_view>
 
@@ -15,9 +17,9 @@ private:
     LibrarySystem* system;
     int bookId;
     std::string title;
-    std::string author;
+    InternedString author;
     std::string isbn;
-    std::string genre;
+    InternedString genre;
     std::string coverPath;
     std::string description;
     std::string pdfPath;
@@ -51,14 +53,15 @@ private:
     LibrarySystem* system;
     int bookId;
     std::string title;
-    std::string author;
+    InternedString author;
     std::string isbn;
-    std::string genre;
+    InternedString genre;
     std::string coverPath;
     std::string description;
     std::string pdfPath;
     int year;
     int quantity;
+    int activeLoans;
     bool available;
     bool manuallyDisabled;
     
@@ -67,12 +70,13 @@ public:
         const Book* book = sys->findBook(id);
         if (book) {
             title = book->getTitle();
-            author = book->getAuthor();
+            author = book->getAuthorKey();
             isbn = book->getIsbn();
             year = book->getYear();
-            genre = book->getGenre();
+            genre = book->getGenreKey();
             coverPath = book->getCoverPath();
             quantity = book->getQuantity();
+            activeLoans = book->getActiveLoans();
             description = book->getDescription();
             pdfPath = book->getPdfPath();
             available = book->isAvailable();
@@ -109,6 +113,8 @@ public:
         Book* book = system->findBook(bookId);
         if (book) {
             book->setManuallyDisabled(manuallyDisabled);
+            // Записи о выдаче у абонентов сохранились, восстанавливаем счётчик
+            book->setActiveLoans(activeLoans);
         }
     }
     
@@ -123,16 +129,16 @@ private:
     LibrarySystem* system;
     int bookId;
     std::string oldTitle;
-    std::string oldAuthor;
+    InternedString oldAuthor;
     std::string oldIsbn;
-    std::string oldGenre;
+    InternedString oldGenre;
     std::string oldCoverPath;
     std::string oldDescription;
     std::string oldPdfPath;
     std::string newTitle;
-    std::string newAuthor;
+    InternedString newAuthor;
     std::string newIsbn;
-    std::string newGenre;
+    InternedString newGenre;
     std::string newCoverPath;
     std::string newDescription;
     std::string newPdfPath;
@@ -155,10 +161,10 @@ public:
         if (book) {
             // Сохраняем старые значения
             oldTitle = book->getTitle();
-            oldAuthor = book->getAuthor();
+            oldAuthor = book->getAuthorKey();
             oldIsbn = book->getIsbn();
             oldYear = book->getYear();
-            oldGenre = book->getGenre();
+            oldGenre = book->getGenreKey();
             oldCoverPath = book->getCoverPath();
             oldQuantity = book->getQuantity();
             oldDescription = book->getDescription();
@@ -376,20 +382,13 @@ private:
     
 public:
     RemoveEmployeeCommand(LibrarySystem* sys, int id) : system(sys), employeeId(id) {
-        const Employee* emp = nullptr;
-        for (const auto* e : sys->getAllEmployees()) {
-            if (e->getId() == id) {
-                emp = e;
-                break;
-            }
-        }
-        if (emp) {
+        if (const Employee* emp = sys->findEmployee(id)) {
             name = emp->getName();
             surname = emp->getSurname();
             phone = emp->getPhone();
             salary = emp->getSalary();
             workHours = emp->getWorkHours();
-            isLibrarian = (emp->getType() == "Librarian");
+            isLibrarian = (emp->getPositionKey() == Librarian::positionKey());
         }
     }
     
@@ -428,20 +427,13 @@ public:
                         std::string_view p, double sal, int hours)
         : system(sys), employeeId(id), newName(n), newSurname(s), newPhone(p),
           newSalary(sal), newWorkHours(hours) {
-        const Employee* emp = nullptr;
-        for (const auto* e : sys->getAllEmployees()) {
-            if (e->getId() == id) {
-                emp = e;
-                break;
-            }
-        }
-        if (emp) {
+        if (const Employee* emp = sys->findEmployee(id)) {
             oldName = emp->getName();
             oldSurname = emp->getSurname();
             oldPhone = emp->getPhone();
             oldSalary = emp->getSalary();
             oldWorkHours = emp->getWorkHours();
-            isLibrarian = (emp->getType() == "Librarian");
+            isLibrarian = (emp->getPositionKey() == Librarian::positionKey());
         }
     }
     
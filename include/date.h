@@ -0,0 +1,123 @@
+#ifndef DATE_H
+#define DATE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Календарная дата как номер дня от 1970-01-01 (4 байта).
+// Строковое представление "%Y-%m-%d" нужно только на границах: в UI и в файлах.
+class Date {
+private:
+    static constexpr std::int32_t NULL_DAYS = std::numeric_limits<std::int32_t>::min();
+    std::int32_t days = NULL_DAYS; // Пустая дата (например, срок возврата не задан)
+
+    constexpr explicit Date(std::int32_t pDays) : days(pDays) {}
+
+    static constexpr bool isLeapYear(int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+    static constexpr unsigned daysInMonth(int y, unsigned m) {
+        constexpr unsigned table[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return (m == 2 && isLeapYear(y)) ? 29 : table[m - 1];
+    }
+
+public:
+    static constexpr size_t ISO_LENGTH = 10; // "YYYY-MM-DD"
+
+    constexpr Date() = default;
+
+    static constexpr Date fromDays(int pDays) { return Date(pDays); }
+
+    static constexpr Date fromCivil(int y, unsigned m, unsigned d) {
+        y -= m <= 2 ? 1 : 0;
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const auto yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return Date(era * 146097 + static_cast<int>(doe) - 719468);
+    }
+
+    // Разбор "%Y-%m-%d"; nullopt, если строка пустая или не является датой
+    static constexpr std::optional<Date> parse(std::string_view str) {
+        int parts[3] = {0, 0, 0};
+        const size_t maxDigits[3] = {4, 2, 2};
+        size_t pos = 0;
+        for (int part = 0; part < 3; ++part) {
+            if (part > 0) {
+                if (pos >= str.size() || str[pos] != '-') return std::nullopt;
+                ++pos;
+            }
+            size_t digits = 0;
+            while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9' && digits < maxDigits[part]) {
+                parts[part] = parts[part] * 10 + (str[pos] - '0');
+                ++pos;
+                ++digits;
+            }
+            if (digits == 0) return std::nullopt;
+        }
+        if (pos != str.size() || parts[1] < 1 || parts[1] > 12 || parts[2] < 1 ||
+            static_cast<unsigned>(parts[2]) > daysInMonth(parts[0], static_cast<unsigned>(parts[1]))) {
+            return std::nullopt;
+        }
+        return fromCivil(parts[0], static_cast<unsigned>(parts[1]), static_cast<unsigned>(parts[2]));
+    }
+
+    // Пустая строка и нераспознанные значения дают пустую дату
+    static constexpr Date fromString(std::string_view str) { return parse(str).value_or(Date()); }
+
+    static Date today(); // Текущая дата по местному времени
+
+    constexpr bool isNull() const { return days == NULL_DAYS; }
+    constexpr int toDays() const { return days; }
+    constexpr Date addDays(int n) const { return isNull() ? *this : Date(days + n); }
+
+    constexpr void toCivil(int& y, unsigned& m, unsigned& d) const {
+        const int z = days + 719468;
+        const int era = (z >= 0 ? z : z - 146096) / 146097;
+        const auto doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<int>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+    }
+
+    // Запись "YYYY-MM-DD" в out без выделения памяти; возвращает указатель за последним символом.
+    // Пустая дата ничего не записывает.
+    constexpr char* formatTo(char* out) const {
+        if (isNull()) return out;
+        int y = 0;
+        unsigned m = 0;
+        unsigned d = 0;
+        toCivil(y, m, d);
+        auto year = static_cast<unsigned>(y < 0 ? 0 : (y > 9999 ? 9999 : y));
+        out[0] = static_cast<char>('0' + year / 1000);
+        out[1] = static_cast<char>('0' + year / 100 % 10);
+        out[2] = static_cast<char>('0' + year / 10 % 10);
+        out[3] = static_cast<char>('0' + year % 10);
+        out[4] = '-';
+        out[5] = static_cast<char>('0' + m / 10);
+        out[6] = static_cast<char>('0' + m % 10);
+        out[7] = '-';
+        out[8] = static_cast<char>('0' + d / 10);
+        out[9] = static_cast<char>('0' + d % 10);
+        return out + ISO_LENGTH;
+    }
+
+    std::string toString() const {
+        char buffer[ISO_LENGTH] = {};
+        return std::string(buffer, formatTo(buffer));
+    }
+
+    friend constexpr bool operator==(Date lhs, Date rhs) { return lhs.days == rhs.days; }
+    friend constexpr bool operator!=(Date lhs, Date rhs) { return lhs.days != rhs.days; }
+    friend constexpr bool operator<(Date lhs, Date rhs) { return lhs.days < rhs.days; }
+    friend constexpr bool operator<=(Date lhs, Date rhs) { return lhs.days <= rhs.days; }
+    friend constexpr bool operator>(Date lhs, Date rhs) { return lhs.days > rhs.days; }
+    friend constexpr bool operator>=(Date lhs, Date rhs) { return lhs.days >= rhs.days; }
+};
+
+#endif // DATE_H
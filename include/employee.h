@@ -2,24 +2,26 @@
 #define EMPLOYEE_H
 
 #include "person.h"
+#include "internedstring.h"
 #include <string>
 #include <string_view>
 
 class Employee : public Person {
 private:
-    std::string position;
+    InternedString position;
     double salary;
     int workHours;
 
 public:
     explicit Employee(int pId, std::string_view pName, std::string_view pSurname, 
-             std::string_view pPhone, std::string_view pPosition, double pSalary, int pWorkHours);
+             std::string_view pPhone, InternedString pPosition, double pSalary, int pWorkHours);
     
-    std::string getPosition() const { return position; }
+    const std::string& getPosition() const { return position.str(); }
+    InternedString getPositionKey() const { return position; } // Сравнение должностей без сравнения строк
     double getSalary() const { return salary; }
     int getWorkHours() const { return workHours; }
     
-    void setPosition(std::string_view pPosition) { position = pPosition; }
+    void setPosition(std::string_view pPosition) { position = InternedString(pPosition); }
     void setSalary(double pSalary) { salary = pSalary; }
     void setWorkHours(int pWorkHours) { workHours = pWorkHours; }
     
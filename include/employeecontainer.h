@@ -0,0 +1,68 @@
+#ifndef EMPLOYEECONTAINER_H
+#define EMPLOYEECONTAINER_H
+
+#include "employee.h"
+#include "librarian.h"
+#include "manager.h"
+#include "idindex.h"
+#include "prefixindex.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "exceptions.h"
+#include <iterator>
+
+class EmployeeContainer {
+private:
+    // Слоты работников в порядке добавления; nullptr - место удалённого работника
+    std::vector<std::unique_ptr<Employee>> employees;
+    IdIndex idIndex; // ID -> позиция слота
+    size_t holes = 0; // Количество пустых слотов
+    std::vector<Librarian*> librarians; // Работники по должностям
+    std::vector<Manager*> managers;
+    PrefixIndex nameIndex; // "Имя Фамилия" - для подсказок при вводе
+
+    void compact(); // Удаление пустых слотов с перестроением индекса
+
+public:
+    class Iterator {
+    private:
+        std::vector<std::unique_ptr<Employee>>::const_iterator it;
+        std::vector<std::unique_ptr<Employee>>::const_iterator last;
+
+        void skipHoles() { while (it != last && !*it) ++it; }
+
+    public:
+        Iterator(std::vector<std::unique_ptr<Employee>>::const_iterator pIt,
+                 std::vector<std::unique_ptr<Employee>>::const_iterator pLast) : it(pIt), last(pLast) { skipHoles(); }
+        
+        Iterator& operator++() { ++it; skipHoles(); return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+        
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.it == rhs.it; }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.it != rhs.it; }
+        
+        Employee& operator*() const { return **it; }
+        Employee* operator->() const { return it->get(); }
+    };
+
+    // Обход без выделения памяти (в отличие от getAllEmployees)
+    Iterator begin() const { return Iterator(employees.begin(), employees.end()); }
+    Iterator end() const { return Iterator(employees.end(), employees.end()); }
+
+    void addEmployee(std::unique_ptr<Employee> employee);
+    void removeEmployee(int id);
+    void syncEmployee(int id); // Обновление индекса после изменения имени или фамилии
+    Employee* findEmployee(int id) const {
+        size_t pos = idIndex.find(id);
+        return (pos != IdIndex::npos) ? employees[pos].get() : nullptr;
+    }
+    std::vector<Employee*> getAllEmployees() const;
+    std::vector<Employee*> suggestEmployees(std::string_view prefix, size_t limit) const; // "Имя Фамилия" начинается с prefix, по алфавиту
+    const std::vector<Librarian*>& getLibrarians() const { return librarians; }
+    const std::vector<Manager*>& getManagers() const { return managers; }
+    size_t size() const { return employees.size() - holes; }
+    bool empty() const { return size() == 0; }
+};
+
+#endif // EMPLOYEECONTAINER_H
@@ -2,31 +2,81 @@
 #define FILEMANAGER_H
 
 #include "librarysystem.h"
+#include "bufferedwriter.h"
+#include "changetracker.h"
+#include <map>
 #include <string>
 #include <string_view>
-#include <fstream>
+#include <vector>
+
+class BinarySnapshot;
 
 class FileManager {
 public:
-    static void saveLibrarySystem(const LibrarySystem& system, std::string_view basePath);
-    static void loadLibrarySystem(LibrarySystem& system, std::string_view basePath);
+    // Контрольная точка, подготовленная в памяти: снимается в потоке интерфейса,
+    // а на диск может записываться в другом потоке (AutoSaver). Данные лежат сегментами -
+    // файлами BinarySnapshot с записями одного раздела (DirtyPartitions)
+    struct Snapshot {
+        bool full = false; // Все разделы: сегменты, которых здесь нет, больше не нужны
+        std::map<std::string, std::string> segments; // "members-3" -> образ; пустой образ - в разделе не осталось записей
+        int nextBookId = 1;
+        int nextEmployeeId = 1;
+
+        void merge(Snapshot newer); // Более поздний снимок поверх этого
+    };
+
+    static Snapshot captureSnapshot(const LibrarySystem& system, const DirtyPartitions& dirty);
+    // Контрольная точка: новые сегменты пишутся в файлы с номером контрольной точки в имени
+    // и сбрасываются на диск, затем manifest.txt со списком действующих сегментов атомарно
+    // заменяется новым. Сбой на любом шаге оставляет прежний набор сегментов целым.
+    // checkpoint - номер контрольной точки, к которой относится журнал после неё
+    static void writeSnapshot(const Snapshot& snapshot, std::string_view basePath, int checkpoint);
+    // Последняя контрольная точка (сегменты из manifest.txt; при переходе со старых версий -
+    // library.bin или текстовые файлы) и изменения из журнала после неё. Изменения из журнала
+    // приходят слушателю LibrarySystem; в журнале они уже есть (см. ChangeTracker::clear)
+    static std::vector<std::string> loadLibrarySystem(LibrarySystem& system, std::string_view basePath); // Описания пропущенных записей
+    
+    // Текстовый формат (books.txt, members.txt, employees.txt, metadata.txt) - для обмена данными
+    static void saveLibrarySystem(const LibrarySystem& system, std::string_view basePath); // Экспорт
+    static std::vector<std::string> importLibrarySystem(LibrarySystem& system, std::string_view basePath); // Импорт, записи добавляются к имеющимся
+    // Преобразование файлов без запуска приложения
+    static std::vector<std::string> convertTextToBinary(std::string_view textPath, std::string_view binaryFile);
+    static std::vector<std::string> convertBinaryToText(std::string_view binaryFile, std::string_view textPath);
+    
+    // Журнал изменений (journal.log, формат - в Journal): строки накопленных изменений
+    // в текущем состоянии, с META и COMMIT в конце
+    static std::string captureJournalBatch(const LibrarySystem& system, const ChangeTracker& changes);
+    static std::string journalPath(std::string_view basePath);
+    static std::string snapshotPath(std::string_view basePath); // Снимок одним файлом (конвертер, старые версии)
+    static std::string manifestPath(std::string_view basePath); // Нет файла - данные ещё не разбиты на сегменты
+    static int readCheckpoint(std::string_view basePath); // Номер контрольной точки снимка (0 - нет)
     
 private:
-    static void saveBooks(const LibrarySystem& system, std::string_view filename);
-    static void loadBooks(LibrarySystem& system, std::string_view filename);
+    static void saveBooks(const LibrarySystem& system, BufferedWriter& file);
+    static void loadBooks(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems);
     
-    static void saveMembers(const LibrarySystem& system, std::string_view filename);
-    static void loadMembers(LibrarySystem& system, std::string_view filename);
+    static void saveMembers(const LibrarySystem& system, BufferedWriter& file);
+    static void loadMembers(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems); // Абоненты и строки BORROWED
     
-    static void saveEmployees(const LibrarySystem& system, std::string_view filename);
-    static void loadEmployees(LibrarySystem& system, std::string_view filename);
+    static void saveEmployees(const LibrarySystem& system, BufferedWriter& file);
+    static void loadEmployees(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems);
     
-    static void saveMetadata(const LibrarySystem& system, std::string_view filename);
-    static void loadMetadata(LibrarySystem& system, std::string_view filename);
+    static void saveMetadata(const LibrarySystem& system, BufferedWriter& file);
+    static int loadMetadata(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems); // Номер контрольной точки
     
-    static void loadBorrowedBooks(LibrarySystem& system, std::string_view filename);
+    // Строки записей - общие для файлов данных и журнала
+    static void writeBook(BufferedWriter& file, const Book& book);
+    static void writeMember(BufferedWriter& file, const LibraryMember& member);
+    static void writeLoan(BufferedWriter& file, const BorrowedBook& loan); // Поля после ID абонента
+    static void writeEmployee(BufferedWriter& file, const Employee& emp);
     
-    static std::vector<std::string> split(std::string_view str, char delimiter);
+    static int loadText(LibrarySystem& system, const std::string& basePath, std::vector<std::string>& problems); // Номер контрольной точки
+    static int loadBinary(LibrarySystem& system, const std::string& snapshotFile, std::vector<std::string>& problems);
+    static int loadSegments(LibrarySystem& system, const std::string& basePath, std::vector<std::string>& problems);
+    static void loadRecords(LibrarySystem& system, const BinarySnapshot& snapshot); // Внутри beginBulkLoad/endBulkLoad
+    static void writeFile(const std::string& path, std::string_view header, std::string_view body); // С записью на диск (fsync)
+    static void recoverSnapshot(const std::string& basePath); // Уборка после прерванной контрольной точки
+    static void replayJournal(LibrarySystem& system, std::string_view filename, int checkpoint, std::vector<std::string>& problems);
 };
 
 #endif // FILEMANAGER_H
@@ -0,0 +1,45 @@
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+// Индекс "ID -> позиция в хранилище контейнера".
+// ID выдаются по порядку (nextBookId, generateId), поэтому они хранятся в таблице
+// с прямой адресацией. Отрицательные и аномально большие ID (например, из
+// повреждённого файла) уходят в хеш-таблицу, чтобы не раздувать таблицу.
+class IdIndex {
+private:
+    static constexpr std::uint32_t EMPTY = UINT32_MAX;
+
+    std::vector<std::uint32_t> direct;
+    std::unordered_map<int, size_t> overflow;
+    size_t count = 0;
+
+    bool fitsDirect(int id) const;
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    size_t find(int id) const {
+        if (id >= 0 && static_cast<size_t>(id) < direct.size() && direct[id] != EMPTY) {
+            return direct[id];
+        }
+        if (overflow.empty()) {
+            return npos;
+        }
+        auto it = overflow.find(id);
+        return (it != overflow.end()) ? it->second : npos;
+    }
+
+    bool contains(int id) const { return find(id) != npos; }
+    void insert(int id, size_t pos); // Добавление или перезапись позиции
+    void erase(int id);
+    void clear();
+    void reserve(int maxId);
+    size_t size() const { return count; }
+};
+
+#endif // IDINDEX_H
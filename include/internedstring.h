@@ -0,0 +1,37 @@
+#ifndef INTERNEDSTRING_H
+#define INTERNEDSTRING_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Строка из общего пула: одинаковые значения (жанры, авторы, должности)
+// хранятся один раз, а сравнение сводится к сравнению номеров.
+// Строки из пула не удаляются до конца работы программы.
+class InternedString {
+public:
+    using Id = std::uint32_t;
+
+private:
+    const std::string* value;
+    Id id;
+
+public:
+    InternedString(); // Пустая строка, номер 0
+    explicit InternedString(std::string_view text);
+
+    const std::string& str() const { return *value; }
+    Id getId() const { return id; }
+    bool empty() const { return value->empty(); }
+
+    operator const std::string&() const { return *value; }
+    operator std::string_view() const { return *value; }
+
+    friend bool operator==(const InternedString& lhs, const InternedString& rhs) { return lhs.id == rhs.id; }
+    friend bool operator!=(const InternedString& lhs, const InternedString& rhs) { return lhs.id != rhs.id; }
+
+    static size_t poolSize(); // Количество различных строк (номера - от 0 до poolSize() - 1)
+};
+
+#endif // INTERNEDSTRING_H
@@ -15,7 +15,7 @@ public:
     virtual ~Item() = default;
 
     int getId() const { return id; }
-    std::string getTitle() const { return title; }
+    const std::string& getTitle() const { return title; }
     bool isAvailable() const { return available; }
 
     void setTitle(std::string_view pTitle) { title = pTitle; }
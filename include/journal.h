@@ -0,0 +1,57 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Журнал изменений (journal.log): файл, в который пакеты записей только дописываются.
+// Первая строка - "JOURNAL|<номер контрольной точки>": журнал относится к контрольной точке
+// с тем же номером в manifest.txt (FileManager::readCheckpoint). Каждый пакет заканчивается
+// строкой COMMIT; хвост без COMMIT (запись прервана сбоем) при открытии отрезается.
+// Пакет считается записанным, когда append вернул управление: данные сброшены на диск (fsync).
+class Journal {
+public:
+    static constexpr std::string_view COMMIT = "COMMIT";
+
+private:
+    std::string path;
+    int generation = -1; // -1 - журнал не открыт
+    size_t length = 0;
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int descriptor = -1;
+#endif
+
+    void openFile(bool truncate);
+    void closeFile();
+    void write(std::string_view data); // Дописывание и сброс на диск
+
+public:
+    explicit Journal(std::string_view pPath);
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Открытие для дописывания: журнал другой контрольной точки или без заголовка
+    // начинается заново, недописанный пакет отрезается. FileException при ошибке
+    void open(int pGeneration);
+    void reset(int pGeneration); // Пустой журнал новой контрольной точки
+    void append(std::string_view batch); // Пакет целиком, с COMMIT в конце
+
+    bool isOpen() const { return generation >= 0; }
+    int getGeneration() const { return generation; }
+    size_t size() const { return length; }
+
+    // Длина начала текста журнала из целых пакетов (включая заголовок);
+    // 0, если заголовок не совпадает с generation
+    static size_t committedLength(std::string_view text, int generation);
+    static std::string header(int generation);
+
+    // Сброс на диск уже закрытого файла и записей каталога (после переименования)
+    static void syncFile(const std::string& filePath);
+    static void syncDirectory(const std::string& directoryPath);
+};
+
+#endif // JOURNAL_H
@@ -17,6 +17,7 @@ public:
     double calculateMonthlySalary() const override;
     std::string getInfo() const override;
     std::string getType() const override { return "Librarian"; }
+    static InternedString positionKey(); // Значение getPositionKey() у всех библиотекарей
 };
 
 #endif // LIBRARIAN_H
@@ -2,60 +2,145 @@
 #define LIBRARYCONTAINER_H
 
 #include "book.h"
+#include "idindex.h"
+#include "slab.h"
+#include "catalogcolumns.h"
+#include "textindex.h"
+#include "prefixindex.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include "exceptions.h"
 #include <iterator>
 #include <string_view>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 class LibraryContainer {
 private:
-    std::vector<std::unique_ptr<Book>> books;
+    struct Slot {
+        Book* book; // nullptr - место удалённой книги
+        SlabHandle handle;
+    };
+
+    Slab<Book> storage; // Сами книги, блоками
+    std::vector<Slot> books; // Слоты книг в порядке добавления
+    IdIndex idIndex; // ID -> позиция слота
+    // ISBN -> книга. Ключ указывает на строку ISBN самой книги: книги не перемещаются в Slab,
+    // а при смене ISBN запись переносится на новую строку, поэтому поиск не создаёт std::string
+    std::unordered_map<std::string_view, Book*> isbnIndex;
+    CatalogColumns columns; // Поля для фильтров, строка = позиция слота
+    TextIndex textIndex; // Слова названий, авторов, жанров и описаний, строки - как в columns
+    PrefixIndex titleIndex; // Названия - для подсказок при вводе
+    size_t holes = 0; // Количество пустых слотов
+    size_t bulkStart = 0; // Позиция первой книги последней массовой загрузки (после finishBulkLoad)
+
+    void link(SlabHandle handle); // Проверка дубликатов и занесение в индексы
+    void compact(); // Удаление пустых слотов с перестроением индекса
 
 public:
     class Iterator {
     private:
-        std::vector<std::unique_ptr<Book>>::iterator it;
+        std::vector<Slot>::const_iterator it;
+        std::vector<Slot>::const_iterator last;
+
+        void skipHoles() { while (it != last && !it->book) ++it; }
 
     public:
-        explicit Iterator(std::vector<std::unique_ptr<Book>>::iterator pIt) : it(pIt) {}
+        Iterator(std::vector<Slot>::const_iterator pIt,
+                 std::vector<Slot>::const_iterator pLast) : it(pIt), last(pLast) { skipHoles(); }
         
-        Iterator& operator++() { ++it; return *this; }
+        Iterator& operator++() { ++it; skipHoles(); return *this; }
         Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
         
         friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.it == rhs.it; }
         friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.it != rhs.it; }
         
-        Book& operator*() { return **it; }
-        Book* operator->() { return it->get(); }
+        Book& operator*() const { return *it->book; }
+        Book* operator->() const { return it->book; }
     };
 
-    Iterator begin() { return Iterator(books.begin()); }
-    Iterator end() { return Iterator(books.end()); }
+    // Обход без выделения памяти (в отличие от getAllBooks)
+    Iterator begin() const { return Iterator(books.begin(), books.end()); }
+    Iterator end() const { return Iterator(books.end(), books.end()); }
 
-    void addBook(std::unique_ptr<Book> book);
+    // Книга создаётся прямо в хранилище; аргументы - как у конструктора Book
+    template<typename... Args>
+    Book& addBook(Args&&... args) {
+        SlabHandle handle = storage.emplace(std::forward<Args>(args)...);
+        try {
+            link(handle);
+        } catch (...) {
+            storage.erase(handle);
+            throw;
+        }
+        return *storage.get(handle);
+    }
+    // Массовая загрузка: книга только добавляется в конец, без проверок и индексов.
+    // До finishBulkLoad она не находится через findBook и не попадает в selectBooks
+    template<typename... Args>
+    Book& appendBook(Args&&... args) {
+        SlabHandle handle = storage.emplace(std::forward<Args>(args)...);
+        try {
+            books.push_back({storage.get(handle), handle});
+        } catch (...) {
+            storage.erase(handle);
+            throw;
+        }
+        return *books.back().book;
+    }
+    void finishBulkLoad(std::vector<std::string>& problems); // Индексы за один проход; дубликаты удаляются и описываются в problems
+    // Книга с этим ID добавлена последней массовой загрузкой, а не была в контейнере раньше.
+    // Действительно сразу после finishBulkLoad, до следующего удаления
+    bool isBulkLoaded(int id) const {
+        size_t pos = idIndex.find(id);
+        return pos != IdIndex::npos && pos >= bulkStart;
+    }
+    void reserve(size_t count); // Место под count книг всего
+    void rebuildColumns(); // Колонки каталога заново по всем книгам
     void removeBook(int id);
-    Book* findBook(int id);
-    const Book* findBook(int id) const;
+    Book* findBook(int id) {
+        size_t pos = idIndex.find(id);
+        return (pos != IdIndex::npos) ? books[pos].book : nullptr;
+    }
+    const Book* findBook(int id) const {
+        size_t pos = idIndex.find(id);
+        return (pos != IdIndex::npos) ? books[pos].book : nullptr;
+    }
+    // Ссылка, которая не "повиснет" после удаления книги: resolve вернёт nullptr
+    SlabHandle getHandle(int id) const {
+        size_t pos = idIndex.find(id);
+        return (pos != IdIndex::npos) ? books[pos].handle : SlabHandle{};
+    }
+    Book* resolve(SlabHandle handle) const { return storage.get(handle); }
     Book* findBookByIsbn(std::string_view isbn);
     const Book* findBookByIsbn(std::string_view isbn) const;
+    void changeIsbn(int id, std::string_view isbn); // Смена ISBN с обновлением индекса
+    // Смена ISBN у нескольких книг одним шагом: сначала освобождаются все старые ISBN, затем
+    // занимаются новые, поэтому обмен и сдвиг ISBN по кругу проходят проверку уникальности.
+    // Книга, чей новый ISBN занят другой книгой, сохраняет прежний (как и те, кто ждал её ISBN)
+    void changeIsbns(const std::vector<std::pair<int, std::string_view>>& changes);
+    void syncBook(int id); // Обновление колонок после изменения полей книги
+    void syncAvailability(int id); // Обновление только доступности (выдача и возврат)
+    std::vector<Book*> selectBooks(const CatalogColumns::Query& query) const; // Фильтр по колонкам, в порядке добавления
+    std::vector<Book*> suggestBooks(std::string_view prefix, size_t limit) const; // Название начинается с prefix, по алфавиту
     std::vector<Book*> getAllBooks() const;
     std::vector<Book*> getAvailableBooks() const;
-    size_t size() const { return books.size(); }
-    bool empty() const { return books.empty(); }
+    size_t size() const { return books.size() - holes; }
+    bool empty() const { return size() == 0; }
     
     // STL алгоритмы
     template<typename Predicate>
     std::vector<Book*> findBooks(Predicate pred) const {
         std::vector<Book*> result;
-        std::copy_if(books.begin(), books.end(), std::back_inserter(result),
-                    [&pred](const std::unique_ptr<Book>& book) {
-                        return pred(book.get());
-                    });
+        for (const auto& slot : books) {
+            if (slot.book && pred(slot.book)) {
+                result.push_back(slot.book);
+            }
+        }
         return result;
     }
 };
 
 #endif // LIBRARYCONTAINER_H
-
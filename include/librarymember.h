@@ -2,26 +2,13 @@
 #define LIBRARYMEMBER_H
 
 #include "person.h"
-#include <vector>
+#include "loanstore.h"
 #include <string>
 #include <string_view>
-#include <ctime>
-
-struct BorrowedBook {
-    int bookId;
-    std::string borrowDate;
-    std::string returnDate;
-    bool returned = false;
-    int employeeId; // ID работника, который выдал книгу
-
-    BorrowedBook(int bookId, std::string_view borrowDate, std::string_view returnDate = "", int employeeId = 0)
-        : bookId(bookId), borrowDate(borrowDate), returnDate(returnDate), employeeId(employeeId) {}
-};
 
 class LibraryMember : public Person {
 private:
-    bool isBlocked = false;
-    std::vector<BorrowedBook> borrowedBooks;
+    bool isBlocked = false; // Выдачи абонента хранятся только в LoanStore
 
 public:
     explicit LibraryMember(int pId, std::string_view pName, std::string_view pSurname, std::string_view pPhone, std::string_view pEmail = "");
@@ -29,15 +16,12 @@ public:
     bool getIsBlocked() const { return isBlocked; }
     void setBlocked(bool pBlocked) { isBlocked = pBlocked; }
     
-    void borrowBook(int bookId, int employeeId = 0);
-    void borrowBookWithDate(int bookId, std::string_view borrowDate, std::string_view returnDate, bool returned, int employeeId = 0);
-    void returnBook(int bookId);
-    std::vector<BorrowedBook> getBorrowedBooks() const { return borrowedBooks; }
-    std::vector<BorrowedBook> getOverdueBooks() const;
+    void borrowBook(const LoanStore& loans, int bookId) const; // Проверка блокировки и повторной выдачи перед записью в loans
+    bool hasBook(const LoanStore& loans, int bookId) const { return loans.findOpen(getId(), bookId) != LoanStore::npos; }
     
     std::string getInfo() const override;
+    std::string getInfo(const LoanStore& loans) const; // С числом выдач из истории абонента
     std::string getType() const override { return "LibraryMember"; }
 };
 
 #endif // LIBRARYMEMBER_H
-
@@ -3,7 +3,11 @@
 
 #include "librarycontainer.h"
 #include "membercontainer.h"
+#include "employeecontainer.h"
+#include "loanstore.h"
+#include "overdueindex.h"
 #include "commandmanager.h"
+#include "changetracker.h"
 #include "book.h"
 #include "librarymember.h"
 #include "employee.h"
@@ -12,20 +16,33 @@
 #include <vector>
 #include <memory>
 #include <string_view>
+#include <string>
 
 class LibrarySystem {
 private:
     LibraryContainer books;
     MemberContainer members;
-    std::vector<std::unique_ptr<Employee>> employees;
+    EmployeeContainer employees;
+    LoanStore loans; // История выдач всех абонентов
+    OverdueIndex dueIndex; // Невозвращённые книги по сроку возврата
     CommandManager commandManagerBooks;      // Для операций с книгами
     CommandManager commandManagerMembers;     // Для операций с абонентами
     CommandManager commandManagerEmployees;  // Для операций с работниками
     int nextBookId = 1;
     int nextEmployeeId = 1;
+    bool bulkLoading = false;
+    std::vector<BorrowedBook> pendingLoans; // Выдачи из файла, ждущие endBulkLoad
+    ChangeListener* changeListener = nullptr; // Журнал изменений; не владеет
+
+    LoanStore::LoanId attachLoan(LibraryMember& member, Book& book, const BorrowedBook& loan); // Запись выдачи и учёт невозвращённой книги
+    void compactLoans(); // LoanStore::compact() с перенумерацией dueIndex и журнала изменений
+    std::vector<std::pair<const LibraryMember*, BorrowedBook>> resolveLoans(const std::vector<OverdueIndex::Entry>& entries) const;
 
 public:
     LibrarySystem();
+    // Перемещение - для замены всех данных разом (повторная загрузка из файлов)
+    LibrarySystem(LibrarySystem&&) = default;
+    LibrarySystem& operator=(LibrarySystem&&) = default;
     
     // Книги
     void addBook(std::string_view title, std::string_view author,
@@ -39,10 +56,18 @@ public:
     void removeBook(int id);
     std::vector<Book*> getAllBooks() const;
     std::vector<Book*> getAvailableBooks() const;
+    std::vector<Book*> findBooks(const CatalogColumns::Query& query) const; // Фильтры таблицы книг по колонкам каталога
+    std::vector<Book*> suggestBooks(std::string_view prefix, size_t limit) const; // Подсказки по началу названия
     Book* findBook(int id);
     const Book* findBook(int id) const;
-    int getBorrowedCount(int bookId) const; // Подсчет количества выданных экземпляров
+    Book* findBookByIsbn(std::string_view isbn); // Поиск по ISBN (например, со сканера штрихкодов)
+    const Book* findBookByIsbn(std::string_view isbn) const;
+    const LibraryContainer& getBooks() const { return books; } // Обход без копирования
+    SlabHandle getBookHandle(int id) const { return books.getHandle(id); }
+    Book* resolveBook(SlabHandle handle) const { return books.resolve(handle); } // nullptr, если книга удалена
+    int getBorrowedCount(int bookId) const; // Количество выданных экземпляров (счётчик книги)
     void updateBookAvailability(int bookId); // Обновление доступности на основе количества
+    std::vector<int> verifyLoanCounters() const; // ID книг, у которых счётчики расходятся с историей выдач
     
     // Абоненты
     int addMember(std::string_view name, std::string_view surname, std::string_view phone, std::string_view email = "");
@@ -53,12 +78,23 @@ public:
     LibraryMember* findMember(int id) const;
     std::vector<LibraryMember*> getAllMembers() const;
     std::vector<LibraryMember*> getBlockedMembers() const;
+    std::vector<LibraryMember*> findMembers(const MemberContainer::Query& query) const; // Фильтры таблицы абонентов по колонкам
+    std::vector<LibraryMember*> suggestMembers(std::string_view prefix, size_t limit) const; // Подсказки по началу "Имя Фамилия"
+    const MemberContainer& getMembers() const { return members; } // Обход без копирования
+    SlabHandle getMemberHandle(int id) const { return members.getHandle(id); }
+    LibraryMember* resolveMember(SlabHandle handle) const { return members.resolve(handle); } // nullptr, если абонент удалён
     
     // Выдача/возврат книг
     void borrowBook(int memberId, int bookId, int employeeId);
     void returnBook(int memberId, int bookId);
     std::vector<BorrowedBook> getMemberBooks(int memberId) const;
-    std::vector<std::pair<const LibraryMember*, BorrowedBook>> getOverdueBooks() const;
+    LoanStore::LoanView getMemberLoans(int memberId) const; // История абонента без копирования
+    std::vector<std::pair<const LibraryMember*, BorrowedBook>> getOverdueBooks() const; // По сроку возврата, от самых старых
+    std::vector<std::pair<const LibraryMember*, BorrowedBook>> getBooksDueWithin(int days) const; // Срок в ближайшие days дней
+    size_t getOverdueCount() const;
+    std::vector<const LibraryMember*> getBookHolders(int bookId) const; // У кого сейчас книга
+    std::vector<BorrowedBook> getEmployeeLoans(int employeeId) const; // Выдачи, оформленные работником
+    const LoanStore& getLoanStore() const { return loans; }
     
     // Работники
     void addLibrarian(std::string_view name, std::string_view surname,
@@ -68,7 +104,12 @@ public:
     void editEmployee(int id, std::string_view name, std::string_view surname,
                       std::string_view phone, double salary, int workHours);
     void removeEmployee(int id);
+    Employee* findEmployee(int id) const;
     std::vector<Employee*> getAllEmployees() const;
+    std::vector<Employee*> suggestEmployees(std::string_view prefix, size_t limit) const; // Подсказки по началу "Имя Фамилия"
+    const std::vector<Librarian*>& getLibrarians() const { return employees.getLibrarians(); }
+    const std::vector<Manager*>& getManagers() const { return employees.getManagers(); }
+    const EmployeeContainer& getEmployees() const { return employees; } // Обход без копирования
     
     // Undo/Redo для книг
     void undoBooks();
@@ -104,12 +145,24 @@ public:
     int getNextEmployeeId() const { return nextEmployeeId; }
     void setNextEmployeeId(int id) { nextEmployeeId = id; }
     
+    // Массовая загрузка из файлов: между beginBulkLoad и endBulkLoad addBookWithId,
+    // addMemberWithId и addBorrowedBook только накапливают записи, а индексы,
+    // проверка дубликатов и ссылок, счётчики и доступность книг делаются один раз в конце
+    void beginBulkLoad(size_t bookCount = 0, size_t memberCount = 0, size_t loanCount = 0); // Ожидаемое число записей, если известно заранее
+    std::vector<std::string> endBulkLoad(); // Описания пропущенных записей
+    bool isBulkLoading() const { return bulkLoading; }
+    
+    // Уведомления об изменениях (журнал); nullptr - без уведомлений
+    void setChangeListener(ChangeListener* listener) { changeListener = listener; }
+    ChangeListener* getChangeListener() const { return changeListener; }
+    
     // Методы для загрузки данных и команд
-    void addBookWithId(int id, std::string_view title, std::string_view author,
+    Book& addBookWithId(int id, std::string_view title, std::string_view author,
                        std::string_view isbn, int year, std::string_view genre, bool available,
                        std::string_view coverPath = "", int quantity = 1,
                        std::string_view description = "", std::string_view pdfPath = "");
     void removeBookDirect(int id); // Прямое удаление без команды (для команд undo/redo)
+    void changeBookIsbns(const std::vector<std::pair<int, std::string_view>>& changes); // ISBN нескольких книг одним шагом (LibraryContainer::changeIsbns)
     void editBookDirect(int id, std::string_view title, std::string_view author,
                        std::string_view isbn, int year, std::string_view genre,
                        std::string_view coverPath, int quantity,
@@ -117,16 +170,19 @@ public:
     void addMemberWithId(int id, std::string_view name, std::string_view surname, 
                          std::string_view phone, bool blocked, std::string_view email = "");
     void removeMemberDirect(int id); // Прямое удаление без команды
-    void editMemberDirect(int id, std::string_view name, std::string_view surname, std::string_view phone, std::string_view email = "") const; // Прямое редактирование без команды
+    void editMemberDirect(int id, std::string_view name, std::string_view surname, std::string_view phone, std::string_view email = ""); // Прямое редактирование без команды
     void blockMemberDirect(int id) const; // Прямая блокировка без команды
     void unblockMemberDirect(int id) const; // Прямая разблокировка без команды
     void addEmployeeWithId(int id, std::string_view name, std::string_view surname,
                           std::string_view phone, double salary, int workHours, bool isLibrarian);
     void removeEmployeeDirect(int id); // Прямое удаление без команды
     void editEmployeeDirect(int id, std::string_view name, std::string_view surname,
-                           std::string_view phone, double salary, int workHours) const; // Прямое редактирование без команды
-    void addBorrowedBook(int memberId, int bookId, std::string_view borrowDate, 
-                        std::string_view returnDate, bool returned, int employeeId = 0);
+                           std::string_view phone, double salary, int workHours); // Прямое редактирование без команды
+    void addBorrowedBook(int memberId, int bookId, Date borrowDate, 
+                        Date returnDate, bool returned, int employeeId = 0);
+    // Запись истории абонента с номером index (по порядку выдачи) при воспроизведении журнала:
+    // index, равный длине истории, добавляет выдачу, меньший - отмечает возврат
+    void restoreLoan(int memberId, size_t index, const BorrowedBook& loan);
 };
 
 #endif // LIBRARYSYSTEM_H
@@ -0,0 +1,109 @@
+#ifndef LOANSTORE_H
+#define LOANSTORE_H
+
+#include "date.h"
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+// Запись о выдаче книги
+struct BorrowedBook {
+    int bookId;
+    Date borrowDate;
+    Date returnDate; // Срок возврата, после возврата - фактическая дата возврата
+    bool returned = false;
+    bool removed = false; // Запись удалённого абонента, ждущая LoanStore::compact()
+    int employeeId; // ID работника, который выдал книгу
+    int memberId = 0; // ID абонента (заполняется LoanStore)
+
+    BorrowedBook(int bookId, Date borrowDate, Date returnDate = Date(), int employeeId = 0)
+        : bookId(bookId), borrowDate(borrowDate), returnDate(returnDate), employeeId(employeeId) {}
+};
+
+// Единое хранилище истории выдач.
+// Записи лежат подряд в векторе, номер записи - её позиция; вторичные индексы
+// позволяют без перебора всех абонентов найти выдачи абонента, книги, работника
+// и все невозвращённые книги.
+class LoanStore {
+public:
+    using LoanId = std::uint32_t;
+    static constexpr LoanId npos = UINT32_MAX;
+    static constexpr int LOAN_PERIOD_DAYS = 30; // Срок выдачи
+
+private:
+    std::vector<BorrowedBook> loans;
+    std::vector<LoanId> openPosition; // Позиция записи в openLoans или npos
+    std::vector<LoanId> openLoans; // Невозвращённые записи
+    std::unordered_map<int, std::vector<LoanId>> byMember;
+    std::unordered_map<int, std::vector<LoanId>> byBook;
+    std::unordered_map<int, std::vector<LoanId>> byEmployee;
+    std::unordered_map<int, std::vector<LoanId>> openByMember;
+    size_t removedCount = 0; // Записи удалённых абонентов (removed), ждущие compact()
+
+    static const std::vector<LoanId>& lookup(const std::unordered_map<int, std::vector<LoanId>>& index, int key);
+    void markClosed(LoanId id);
+
+public:
+    // Записи по списку номеров без копирования (например, история абонента).
+    // Действительно до следующего изменения хранилища.
+    class LoanView {
+    private:
+        const LoanStore* store;
+        const std::vector<LoanId>* ids;
+
+    public:
+        class Iterator {
+        private:
+            const LoanStore* store;
+            std::vector<LoanId>::const_iterator it;
+
+        public:
+            Iterator(const LoanStore* pStore, std::vector<LoanId>::const_iterator pIt) : store(pStore), it(pIt) {}
+            
+            Iterator& operator++() { ++it; return *this; }
+            Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+            
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.it == rhs.it; }
+            friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.it != rhs.it; }
+            
+            const BorrowedBook& operator*() const { return store->get(*it); }
+            const BorrowedBook* operator->() const { return &store->get(*it); }
+        };
+
+        LoanView(const LoanStore* pStore, const std::vector<LoanId>* pIds) : store(pStore), ids(pIds) {}
+
+        Iterator begin() const { return Iterator(store, ids->begin()); }
+        Iterator end() const { return Iterator(store, ids->end()); }
+        size_t size() const { return ids->size(); }
+        bool empty() const { return ids->empty(); }
+        const BorrowedBook& operator[](size_t i) const { return store->get((*ids)[i]); }
+    };
+
+    LoanId add(int memberId, const BorrowedBook& loan);
+    void close(LoanId id, Date returnDate); // Отметка о возврате
+    void removeMember(int memberId); // Удаление истории абонента из индексов
+    bool needsCompaction() const; // Записей удалённых абонентов больше половины
+    // Удаление записей удалённых абонентов. Номера остальных записей меняются: результат -
+    // новый номер для каждого старого (npos для удалённых записей)
+    std::vector<LoanId> compact();
+    void clear();
+    void reserve(size_t count, size_t memberCount = 0, size_t bookCount = 0); // Записей всего; абонентов и книг - для индексов
+
+    const BorrowedBook& get(LoanId id) const { return loans[id]; }
+    LoanId findOpen(int memberId, int bookId) const;
+    size_t size() const { return loans.size(); }
+    size_t openCount() const { return openLoans.size(); }
+
+    // Номера записей в порядке выдачи
+    const std::vector<LoanId>& getMemberLoans(int memberId) const { return lookup(byMember, memberId); }
+    const std::vector<LoanId>& getBookLoans(int bookId) const { return lookup(byBook, bookId); }
+    const std::vector<LoanId>& getEmployeeLoans(int employeeId) const { return lookup(byEmployee, employeeId); }
+    const std::vector<LoanId>& getMemberOpenLoans(int memberId) const { return lookup(openByMember, memberId); }
+    const std::vector<LoanId>& getOpenLoans() const { return openLoans; } // Порядок не гарантируется
+
+    LoanView view(const std::vector<LoanId>& ids) const { return LoanView(this, &ids); }
+    std::vector<BorrowedBook> collect(const std::vector<LoanId>& ids) const;
+};
+
+#endif // LOANSTORE_H
@@ -24,8 +24,11 @@
 #include <QSpinBox>
 #include <QComboBox>
 #include <QStringList>
+#include <QTimer>
 #include "librarysystem.h"
 #include "filemanager.h"
+#include "autosaver.h"
+#include "suggestionmodel.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -73,6 +76,8 @@ private slots:
     void onRedoEmployees();
     void onSave();
     void onLoad();
+    void onExportText();
+    void onImportText();
     void refreshBooks();
     void refreshMembers();
     void refreshEmployees();
@@ -87,10 +92,16 @@ private:
     std::unique_ptr<Ui::MainWindow> ui;
     LibrarySystem librarySystem;
     QString dataPath = "data";
+    static constexpr int AUTOSAVE_DELAY_MS = 500; // Серия правок за это время сохраняется одним пакетом журнала
+    static constexpr size_t CHECKPOINT_JOURNAL_BYTES = 8 * 1024 * 1024; // Журнал длиннее - пора контрольная точка
+    ChangeTracker changeTracker; // Изменения, ещё не переданные в журнал
+    std::unique_ptr<AutoSaver> autoSaver; // Запись на диск в фоновом потоке
+    QTimer* autoSaveTimer = nullptr;
     QMap<int, int> bookSortStates; // колонка -> состояние (0=неактивна, 1=возрастание, 2=убывание)
     
     // Фильтры для книг
     struct BookFilters {
+        QString text; // Слова из названия, автора, жанра или описания
         QString title;
         QString author;
         QString genre;
@@ -119,7 +130,11 @@ private:
     void setupOperationsTab();
     void showError(const QString& message);
     void showInfo(const QString& message);
-    void autoSave() const; // Автоматическое сохранение
+    void showLoadProblems(const std::vector<std::string>& problems); // Отчёт о пропущенных при загрузке записях
+    void autoSave() const; // Автоматическое сохранение (отложенное, запись в фоне)
+    void submitAutoSave(); // Пакет журнала (или снимок, если журнал разросся) для фоновой записи
+    void saveNow(); // Контрольная точка с ожиданием; FileException при ошибке
+    void commitNow(); // Запись накопленных изменений в журнал с ожиданием; FileException при ошибке
     void updateUndoRedoButtons() const; // Обновление состояния кнопок undo/redo во всех вкладках
     void applyBookSorting(QTableWidget* table) const; // Применение сортировки книг
     QIcon createRedCrossIcon() const; // Создание красной иконки крестика
@@ -144,6 +159,15 @@ private:
     QWidget* createActionWidget() const; // Создание виджета для кнопок действий
     QPushButton* createActionButton(const QIcon& icon, const QString& tooltip, std::function<void()> onClick) const; // Создание кнопки действия
     QComboBox* createComboBoxWithCompleter(QWidget* parent, const QStringList& items, const QList<int>& ids = {}, int defaultId = -1) const; // Создание QComboBox с completer
+    
+    // Поля выбора абонента/книги/работника: подсказки по мере ввода из индексов LibrarySystem
+    QLineEdit* createLookupField(QWidget* parent, SuggestionModel::Source source, std::function<void(int)> onSelected = {}) const; // onSelected(-1) - выбор сброшен вводом
+    static int lookupId(const QLineEdit* field); // ID выбранной записи или -1
+    static void setLookupValue(QLineEdit* field, const QString& text, int id);
+    void setDefaultEmployee(QLineEdit* field) const; // Первый работник, как раньше в выпадающем списке
+    SuggestionModel::Source memberSuggestions() const;
+    SuggestionModel::Source bookSuggestions() const;
+    SuggestionModel::Source employeeSuggestions() const;
     void executeWithRefresh(std::function<void()> action, const QString& successMessage, const QString& errorContext = ""); // Выполнение действия с обновлением UI
 };
 
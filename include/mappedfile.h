@@ -0,0 +1,27 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Файл, отображённый в память только для чтения.
+// Содержимое доступно как string_view без копирования в буферы потока;
+// представление действительно, пока жив объект MappedFile.
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    bool opened = false;
+
+public:
+    explicit MappedFile(const std::string& path); // Файл, которого нет, не считается ошибкой: isOpen() == false
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    std::string_view view() const { return std::string_view(data, length); }
+};
+
+#endif // MAPPEDFILE_H
@@ -2,63 +2,146 @@
 #define MEMBERCONTAINER_H
 
 #include "librarymember.h"
+#include "idindex.h"
+#include "slab.h"
+#include "substringcolumn.h"
+#include "prefixindex.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include "exceptions.h"
 #include <iterator>
+#include <string>
 
 class MemberContainer {
+public:
+    struct Query {
+        std::string name; // Подстроки без учёта регистра; пустая строка - без фильтра
+        std::string surname;
+        std::string phone; // Подстрока как есть
+        std::string email;
+        int blocked = -1; // -1 - все, 1 - заблокированные, 0 - незаблокированные
+    };
+
 private:
-    std::vector<std::unique_ptr<LibraryMember>> members;
+    struct Slot {
+        LibraryMember* member; // nullptr - место удалённого абонента
+        SlabHandle handle;
+    };
+
+    Slab<LibraryMember> storage; // Сами абоненты, блоками
+    std::vector<Slot> members; // Слоты абонентов в порядке добавления
+    IdIndex idIndex; // ID -> позиция слота
+    size_t holes = 0; // Количество пустых слотов
+    size_t bulkStart = 0; // Позиция первого абонента последней массовой загрузки (после finishBulkLoad)
     int nextId = 1;
+    // Поля для фильтров таблицы абонентов, строка = позиция слота
+    SubstringColumn names; // Имя, фамилия и email - в нижнем регистре (foldCase)
+    SubstringColumn surnames;
+    SubstringColumn phones;
+    SubstringColumn emails;
+    PrefixIndex nameIndex; // "Имя Фамилия" - для подсказок при вводе
+
+    void link(SlabHandle handle); // Проверка дубликатов и занесение в индекс
+    void compact(); // Удаление пустых слотов с перестроением индекса
+    void appendColumns(const LibraryMember* member); // Строка колонок для слота; nullptr - пустая
+    void rebuildColumns();
 
 public:
     MemberContainer() = default;
 
     class Iterator {
     private:
-        std::vector<std::unique_ptr<LibraryMember>>::iterator it;
+        std::vector<Slot>::const_iterator it;
+        std::vector<Slot>::const_iterator last;
+
+        void skipHoles() { while (it != last && !it->member) ++it; }
 
     public:
-        explicit Iterator(std::vector<std::unique_ptr<LibraryMember>>::iterator pIt) : it(pIt) {}
+        Iterator(std::vector<Slot>::const_iterator pIt,
+                 std::vector<Slot>::const_iterator pLast) : it(pIt), last(pLast) { skipHoles(); }
         
-        Iterator& operator++() { ++it; return *this; }
+        Iterator& operator++() { ++it; skipHoles(); return *this; }
         Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
         
         friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.it == rhs.it; }
         friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.it != rhs.it; }
         
-        LibraryMember& operator*() { return **it; }
-        LibraryMember* operator->() { return it->get(); }
+        LibraryMember& operator*() const { return *it->member; }
+        LibraryMember* operator->() const { return it->member; }
     };
 
-    Iterator begin() { return Iterator(members.begin()); }
-    Iterator end() { return Iterator(members.end()); }
+    // Обход без выделения памяти (в отличие от getAllMembers)
+    Iterator begin() const { return Iterator(members.begin(), members.end()); }
+    Iterator end() const { return Iterator(members.end(), members.end()); }
 
     int generateId() { return nextId++; }
     void setNextId(int id) { nextId = id; }
     int getNextId() const { return nextId; }
 
-    void addMember(std::unique_ptr<LibraryMember> member);
+    // Абонент создаётся прямо в хранилище; аргументы - как у конструктора LibraryMember
+    template<typename... Args>
+    LibraryMember& addMember(Args&&... args) {
+        SlabHandle handle = storage.emplace(std::forward<Args>(args)...);
+        try {
+            link(handle);
+        } catch (...) {
+            storage.erase(handle);
+            throw;
+        }
+        return *storage.get(handle);
+    }
+    // Массовая загрузка: абонент только добавляется в конец, без проверок и индекса.
+    // До finishBulkLoad он не находится через findMember
+    template<typename... Args>
+    LibraryMember& appendMember(Args&&... args) {
+        SlabHandle handle = storage.emplace(std::forward<Args>(args)...);
+        try {
+            members.push_back({storage.get(handle), handle});
+        } catch (...) {
+            storage.erase(handle);
+            throw;
+        }
+        return *members.back().member;
+    }
+    void finishBulkLoad(std::vector<std::string>& problems); // Индекс за один проход; дубликаты удаляются и описываются в problems
+    // Абонент с этим ID добавлен последней массовой загрузкой, а не был в контейнере раньше.
+    // Действительно сразу после finishBulkLoad, до следующего удаления
+    bool isBulkLoaded(int id) const {
+        size_t pos = idIndex.find(id);
+        return pos != IdIndex::npos && pos >= bulkStart;
+    }
+    void reserve(size_t count); // Место под count абонентов всего
     void removeMember(int id);
-    LibraryMember* findMember(int id) const;
+    void syncMember(int id); // Обновление колонок после изменения полей абонента
+    LibraryMember* findMember(int id) const {
+        size_t pos = idIndex.find(id);
+        return (pos != IdIndex::npos) ? members[pos].member : nullptr;
+    }
+    // Ссылка, которая не "повиснет" после удаления абонента: resolve вернёт nullptr
+    SlabHandle getHandle(int id) const {
+        size_t pos = idIndex.find(id);
+        return (pos != IdIndex::npos) ? members[pos].handle : SlabHandle{};
+    }
+    LibraryMember* resolve(SlabHandle handle) const { return storage.get(handle); }
     std::vector<LibraryMember*> getAllMembers() const;
     std::vector<LibraryMember*> getBlockedMembers() const;
-    size_t size() const { return members.size(); }
-    bool empty() const { return members.empty(); }
+    std::vector<LibraryMember*> selectMembers(const Query& query) const; // Фильтр по колонкам, в порядке добавления
+    std::vector<LibraryMember*> suggestMembers(std::string_view prefix, size_t limit) const; // "Имя Фамилия" начинается с prefix, по алфавиту
+    size_t size() const { return members.size() - holes; }
+    bool empty() const { return size() == 0; }
     
     // STL алгоритмы
     template<typename Predicate>
     std::vector<LibraryMember*> findMembers(Predicate pred) const {
         std::vector<LibraryMember*> result;
-        std::copy_if(members.begin(), members.end(), std::back_inserter(result),
-                    [&pred](const std::unique_ptr<LibraryMember>& member) {
-                        return pred(member.get());
-                    });
+        for (const auto& slot : members) {
+            if (slot.member && pred(slot.member)) {
+                result.push_back(slot.member);
+            }
+        }
         return result;
     }
 };
 
 #endif // MEMBERCONTAINER_H
-
@@ -0,0 +1,39 @@
+#ifndef OVERDUEINDEX_H
+#define OVERDUEINDEX_H
+
+#include "date.h"
+#include "loanstore.h"
+#include <set>
+#include <vector>
+#include <tuple>
+#include <cstddef>
+
+// Невозвращённые выдачи (номера записей LoanStore), упорядоченные по сроку возврата.
+// Запросы "просрочено на сегодня" и "срок в ближайшие N дней" - это диапазоны set.
+class OverdueIndex {
+public:
+    struct Entry {
+        Date dueDate;
+        LoanStore::LoanId loanId;
+
+        friend bool operator<(const Entry& lhs, const Entry& rhs) {
+            return std::tie(lhs.dueDate, lhs.loanId) < std::tie(rhs.dueDate, rhs.loanId);
+        }
+    };
+
+private:
+    std::set<Entry> entries;
+
+public:
+    void add(Date dueDate, LoanStore::LoanId loanId) { entries.insert({dueDate, loanId}); }
+    void remove(Date dueDate, LoanStore::LoanId loanId) { entries.erase({dueDate, loanId}); }
+    void clear() { entries.clear(); }
+    size_t size() const { return entries.size(); }
+
+    // Просроченными считаются книги со сроком не позже date (как и раньше, день срока уже просрочка)
+    std::vector<Entry> getOverdue(Date date) const;
+    size_t countOverdue(Date date) const;
+    std::vector<Entry> getDueBetween(Date from, Date to) const; // Срок в [from, to]
+};
+
+#endif // OVERDUEINDEX_H
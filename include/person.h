@@ -18,10 +18,10 @@ public:
     virtual ~Person() = default;
 
     int getId() const { return id; }
-    std::string getName() const { return name; }
-    std::string getSurname() const { return surname; }
-    std::string getPhone() const { return phone; }
-    std::string getEmail() const { return email; }
+    const std::string& getName() const { return name; }
+    const std::string& getSurname() const { return surname; }
+    const std::string& getPhone() const { return phone; }
+    const std::string& getEmail() const { return email; }
     std::string getFullName() const;
 
     void setName(std::string_view pName) { name = pName; }
@@ -0,0 +1,33 @@
+#ifndef PREFIXINDEX_H
+#define PREFIXINDEX_H
+
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+// Упорядоченные ключи (foldCase) записей для подсказок при вводе: записи, ключ которых
+// начинается с введённого текста, лежат подряд, поэтому первые limit из них находятся
+// за O(log n + limit) - без обхода всех записей.
+class PrefixIndex {
+private:
+    using Entries = std::set<std::pair<std::string, int>>; // Ключ и ID: одинаковые ключи различаются по ID
+
+    Entries entries;
+    std::unordered_map<int, Entries::const_iterator> byId; // Для замены и удаления
+
+public:
+    void set(int id, std::string_view text); // Новая запись или новый текст существующей
+    void erase(int id);
+    void assign(const std::vector<std::pair<int, std::string>>& items); // Все записи сразу (загрузка)
+    void clear();
+    size_t size() const { return entries.size(); }
+
+    // ID записей, ключ которых начинается с prefix, по алфавиту; не больше limit
+    std::vector<int> find(std::string_view prefix, size_t limit) const;
+};
+
+#endif // PREFIXINDEX_H
@@ -0,0 +1,131 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// Ссылка на объект в Slab: номер ячейки и её поколение.
+// После удаления объекта поколение ячейки растёт, и старая ссылка перестаёт
+// разрешаться (get возвращает nullptr), даже если ячейку занял новый объект.
+struct SlabHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; // 0 - пустая ссылка
+
+    bool isNull() const { return generation == 0; }
+
+    friend bool operator==(const SlabHandle& lhs, const SlabHandle& rhs) {
+        return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+    friend bool operator!=(const SlabHandle& lhs, const SlabHandle& rhs) { return !(lhs == rhs); }
+};
+
+// Хранилище объектов блоками по CHUNK_SIZE штук вместо отдельного выделения
+// памяти на каждый объект. Объекты не перемещаются, пока живы; освободившиеся
+// ячейки используются повторно.
+template<typename T>
+class Slab {
+public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+private:
+    struct Chunk {
+        alignas(T) unsigned char storage[CHUNK_SIZE * sizeof(T)];
+
+        T* at(size_t i) { return std::launder(reinterpret_cast<T*>(storage + i * sizeof(T))); }
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<std::uint32_t> generations; // Поколение ячейки; нечётное - ячейка занята
+    std::vector<std::uint32_t> freeSlots;
+    size_t count = 0;
+
+    T* slot(std::uint32_t index) const { return chunks[index / CHUNK_SIZE]->at(index % CHUNK_SIZE); }
+    static bool isLive(std::uint32_t generation) { return (generation & 1u) != 0; }
+
+public:
+    Slab() = default;
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+    // Объекты переезжают вместе с блоками, поэтому указатели на них остаются действительными
+    Slab(Slab&& other) noexcept
+        : chunks(std::move(other.chunks)), generations(std::move(other.generations)),
+          freeSlots(std::move(other.freeSlots)), count(std::exchange(other.count, 0)) {
+        other.chunks.clear();
+        other.generations.clear();
+        other.freeSlots.clear();
+    }
+    Slab& operator=(Slab&& other) noexcept {
+        if (this != &other) {
+            clear();
+            chunks = std::move(other.chunks);
+            generations = std::move(other.generations);
+            freeSlots = std::move(other.freeSlots);
+            count = std::exchange(other.count, 0);
+            other.chunks.clear();
+            other.generations.clear();
+            other.freeSlots.clear();
+        }
+        return *this;
+    }
+    ~Slab() { clear(); }
+
+    template<typename... Args>
+    SlabHandle emplace(Args&&... args) {
+        std::uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(generations.size());
+            if (index % CHUNK_SIZE == 0) {
+                chunks.push_back(std::make_unique<Chunk>());
+            }
+            generations.push_back(0);
+        }
+        ::new (static_cast<void*>(slot(index))) T(std::forward<Args>(args)...);
+        ++generations[index];
+        ++count;
+        return {index, generations[index]};
+    }
+
+    T* get(SlabHandle handle) const {
+        if (handle.index >= generations.size() || generations[handle.index] != handle.generation || !isLive(handle.generation)) {
+            return nullptr;
+        }
+        return slot(handle.index);
+    }
+
+    void erase(SlabHandle handle) {
+        T* object = get(handle);
+        if (!object) return;
+        object->~T();
+        ++generations[handle.index];
+        freeSlots.push_back(handle.index);
+        --count;
+    }
+
+    void clear() {
+        for (std::uint32_t i = 0; i < generations.size(); ++i) {
+            if (isLive(generations[i])) {
+                slot(i)->~T();
+                ++generations[i];
+                freeSlots.push_back(i);
+            }
+        }
+        count = 0;
+    }
+
+    void reserve(size_t capacity) {
+        generations.reserve(capacity);
+        chunks.reserve((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return chunks.size() * CHUNK_SIZE; }
+};
+
+#endif // SLAB_H
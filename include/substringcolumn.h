@@ -0,0 +1,57 @@
+#ifndef SUBSTRINGCOLUMN_H
+#define SUBSTRINGCOLUMN_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+// Номер младшего установленного бита (bits != 0)
+inline size_t lowestBit(std::uint64_t bits) {
+    size_t index = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+// Колонка строк с триграммным индексом для фильтра "содержит подстроку".
+// Для каждых трёх подряд идущих байтов хранится отсортированный список строк, где они
+// встречаются. Строка, содержащая искомую подстроку, содержит и все её триграммы, поэтому
+// подстрока проверяется только у строк из пересечения списков, а не у всей колонки.
+// Значения хранятся как переданы: приведение регистра (foldCase) - на стороне вызывающего.
+class SubstringColumn {
+public:
+    using Word = std::uint64_t; // Маски строк - по биту на строку, как в CatalogColumns
+    static constexpr size_t WORD_BITS = 64;
+
+private:
+    using Postings = std::vector<std::uint32_t>; // Номера строк по возрастанию
+
+    std::vector<std::string> values;
+    std::unordered_map<std::uint32_t, Postings> trigrams; // Три байта -> строки
+
+    void link(size_t row, std::string_view value);
+    void unlink(size_t row, std::string_view value);
+    // Оставляет в mask только строки со всеми триграммами needle; false - индекс
+    // не сужает выбор заметно, и mask не изменена
+    bool filterTrigrams(std::vector<Word>& mask, std::string_view needle) const;
+
+public:
+    void append(std::string value); // Новая строка в конце
+    void appendEmpty();
+    void set(size_t row, std::string value);
+    void clear();
+    void reserve(size_t count);
+    size_t size() const { return values.size(); }
+    const std::string& operator[](size_t row) const { return values[row]; }
+
+    // Снимает в mask строки, не содержащие needle. Подстроки короче трёх байтов
+    // проверяются у всех отмеченных строк
+    void filter(std::vector<Word>& mask, std::string_view needle) const;
+};
+
+#endif // SUBSTRINGCOLUMN_H
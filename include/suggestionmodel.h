@@ -0,0 +1,38 @@
+#ifndef SUGGESTIONMODEL_H
+#define SUGGESTIONMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <functional>
+#include <vector>
+
+// Модель подсказок для QCompleter: хранит только первые подходящие записи для текущего
+// ввода и запрашивает их у источника (индексы LibrarySystem) при каждом изменении текста.
+// Поэтому открытие диалога не зависит от размера базы, а QCompleter не перебирает все записи.
+class SuggestionModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    struct Item {
+        QString text;
+        int id;
+    };
+    using Source = std::function<std::vector<Item>(const QString& prefix)>;
+
+    static constexpr int ID_ROLE = Qt::UserRole; // ID записи в data()
+
+    explicit SuggestionModel(Source pSource, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void setPrefix(const QString& prefix); // Новые подсказки для введённого текста
+    int findExact(const QString& text) const; // ID подсказки с таким же текстом (без учёта регистра) или -1
+
+private:
+    Source source;
+    std::vector<Item> items;
+};
+
+#endif // SUGGESTIONMODEL_H
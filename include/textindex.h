@@ -0,0 +1,57 @@
+#ifndef TEXTINDEX_H
+#define TEXTINDEX_H
+
+#include "book.h"
+#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Обратный индекс слов каталога: слово -> строки (как в CatalogColumns, строка = слот
+// LibraryContainer), в названии, авторе, жанре или описании которых оно встречается.
+// Списки строк отсортированы, поэтому запрос из нескольких слов - пересечение списков,
+// и его цена зависит от длины списков, а не от размера каталога.
+class TextIndex {
+private:
+    using Postings = std::vector<std::uint32_t>; // Номера строк по возрастанию
+    using Dictionary = std::unordered_map<std::string, Postings>;
+    using Entry = Dictionary::value_type; // Узлы не перемещаются, указатели на них стабильны
+
+    Dictionary words;
+    std::vector<std::vector<Entry*>> rowWords; // Слова каждой строки - для обновления и удаления
+    // Слова по алфавиту - для поиска по началу слова. После clear не ведётся и строится
+    // при первом таком поиске: при загрузке каталога не тратится время на сортировку
+    mutable std::vector<const Entry*> sortedWords;
+    mutable bool sorted = true;
+
+    void link(size_t row, const std::vector<std::string>& tokens);
+    void unlink(size_t row, Entry* word);
+    const std::vector<const Entry*>& alphabet() const;
+
+public:
+    TextIndex() = default;
+    TextIndex(const TextIndex&) = delete; // rowWords и sortedWords ссылаются на узлы words
+    TextIndex& operator=(const TextIndex&) = delete;
+    TextIndex(TextIndex&&) = default;
+    TextIndex& operator=(TextIndex&&) = default;
+
+    // Слова в нижнем регистре (foldCase), ё приводится к е: из текста - по порядку,
+    // из полей книги - отсортированные и без повторов
+    static void tokenize(std::string_view text, std::vector<std::string>& tokens);
+    static void tokenize(const Book& book, std::vector<std::string>& tokens);
+
+    void append(const Book& book); // Новая строка в конце
+    void appendEmpty();
+    void update(size_t row, const Book& book);
+    void erase(size_t row);
+    void clear();
+    void reserve(size_t count);
+
+    // Строки, где есть все слова запроса (tokenize); последнее слово - как начало слова,
+    // чтобы поиск работал по мере ввода. Номера строк по возрастанию
+    std::vector<size_t> search(const std::vector<std::string>& query) const;
+};
+
+#endif // TEXTINDEX_H
@@ -0,0 +1,151 @@
+#include "autosaver.h"
+#include "exceptions.h"
+
+AutoSaver::AutoSaver(std::string_view pBasePath, ErrorHandler pOnError)
+    : basePath(pBasePath), onError(std::move(pOnError)), journal(FileManager::journalPath(pBasePath)),
+      worker(&AutoSaver::run, this) {}
+
+AutoSaver::~AutoSaver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorker.notify_one();
+    worker.join();
+}
+
+void AutoSaver::append(std::string batch) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (journalFailed) {
+            return; // Журнал уже неполон - изменения войдут в следующий снимок
+        }
+        pendingRecords += batch;
+    }
+    wakeWorker.notify_one();
+}
+
+void AutoSaver::submit(FileManager::Snapshot snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        enqueue(std::move(snapshot));
+    }
+    wakeWorker.notify_one();
+}
+
+void AutoSaver::save(FileManager::Snapshot snapshot) {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Ожидающий отмечается до того, как снимок увидит поток записи,
+    // поэтому ошибка этой записи гарантированно придёт сюда
+    enqueue(std::move(snapshot));
+    wait(lock);
+}
+
+void AutoSaver::enqueue(FileManager::Snapshot snapshot) {
+    // Сегменты снимков, ещё не попавших на диск, нужны и новой контрольной точке:
+    // новый снимок ложится поверх ждущего, ждущий - поверх несохранённого
+    if (pending) {
+        pending->merge(std::move(snapshot));
+    } else {
+        pending = std::move(snapshot);
+    }
+    if (unwritten) {
+        unwritten->merge(std::move(*pending));
+        pending = std::move(unwritten);
+        unwritten.reset();
+    }
+    pendingRecords.clear(); // Пакеты до снимка в нём уже учтены
+    journalFailed = false;
+}
+
+void AutoSaver::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    wait(lock);
+}
+
+bool AutoSaver::needsCheckpoint() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return journalFailed || unwritten;
+}
+
+void AutoSaver::wait(std::unique_lock<std::mutex>& lock) {
+    ++flushWaiters;
+    wakeWorker.notify_one();
+    writeDone.wait(lock, [this] { return !pending && pendingRecords.empty() && !writing; });
+    --flushWaiters;
+    if (flushError) {
+        std::exception_ptr error = flushError;
+        flushError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void AutoSaver::write(const std::optional<FileManager::Snapshot>& snapshot, const std::string& records) {
+    if (!journal.isOpen()) {
+        journal.open(FileManager::readCheckpoint(basePath));
+    }
+    if (snapshot) {
+        // Журнал следующей контрольной точки начинается только после замены файлов:
+        // при сбое между ними старый журнал не подходит к новому снимку и не воспроизводится
+        int checkpoint = journal.getGeneration() + 1;
+        FileManager::writeSnapshot(*snapshot, basePath, checkpoint);
+        journal.reset(checkpoint);
+    }
+    if (!records.empty()) {
+        journal.append(records);
+    }
+}
+
+void AutoSaver::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorker.wait(lock, [this] { return pending || !pendingRecords.empty() || stopping; });
+        if (!pending && pendingRecords.empty()) {
+            return; // stopping, и всё уже записано
+        }
+        std::optional<FileManager::Snapshot> snapshot = std::move(pending);
+        pending.reset();
+        std::string records = std::move(pendingRecords);
+        pendingRecords.clear();
+        writing = true;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            write(snapshot, records);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        journalBytes = journal.isOpen() ? journal.size() : 0;
+
+        lock.lock();
+        writing = false;
+        if (error && snapshot) {
+            // Более свежий ждущий снимок дополняется несохранёнными сегментами и пишется следом
+            if (pending) {
+                snapshot->merge(std::move(*pending));
+                pending = std::move(snapshot);
+            } else {
+                unwritten = std::move(snapshot);
+            }
+        }
+        if (error && !pending) {
+            // Без пропавшего пакета журнал не восстановить - до следующего снимка он не пишется
+            journalFailed = true;
+            pendingRecords.clear();
+        }
+        // Ошибку получает ждущий save/sync; если его нет - обработчик (вне блокировки)
+        bool report = error && flushWaiters == 0;
+        flushError = report ? nullptr : error;
+        writeDone.notify_all();
+        if (report && onError) {
+            lock.unlock();
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                onError(e.what());
+            }
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,387 @@
+#include "binarysnapshot.h"
+#include "librarysystem.h"
+#include "exceptions.h"
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr char MAGIC[8] = {'L', 'I', 'B', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Поля заголовка (смещения от начала файла)
+constexpr size_t AT_VERSION = 8;
+constexpr size_t AT_BYTE_ORDER = 12;
+constexpr size_t AT_SECTION_COUNT = 16;
+constexpr size_t AT_CHECKPOINT = 20;
+constexpr size_t AT_NEXT_BOOK_ID = 24;
+constexpr size_t AT_NEXT_EMPLOYEE_ID = 28;
+constexpr size_t AT_FILE_SIZE = 32;
+constexpr size_t AT_HEADER_CRC = 40;
+constexpr size_t AT_SECTIONS = 64;
+constexpr size_t SECTION_ENTRY_SIZE = 32; // Вид, CRC, смещение, размер, записей
+
+// Заголовок раздела: записей, колонок int32, колонок double, колонок строк
+constexpr size_t TABLE_HEADER_SIZE = 16;
+
+template<typename T>
+void put(std::string& image, size_t at, T value) {
+    std::memcpy(image.data() + at, &value, sizeof(value));
+}
+
+template<typename T>
+void append(std::string& image, T value) {
+    image.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+T get(const char* at) {
+    T value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+void alignTo8(std::string& image) {
+    image.resize((image.size() + 7) / 8 * 8, '\0');
+}
+
+// CRC-32 (IEEE, как в zip) по 8 байт за шаг
+using CrcTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+const CrcTables& crcTables() {
+    static const CrcTables tables = [] {
+        CrcTables t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0u);
+            }
+            t[0][i] = crc;
+        }
+        for (size_t k = 1; k < 8; ++k) {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+std::uint32_t crc32(const char* data, size_t size, std::uint32_t crc = 0) {
+    const CrcTables& t = crcTables();
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        std::uint32_t low = crc ^ (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24));
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return ~crc;
+}
+
+// CRC заголовка вместе с таблицей разделов, без поля самой CRC
+std::uint32_t headerCrc(const char* header) {
+    std::uint32_t crc = crc32(header, AT_HEADER_CRC);
+    return crc32(header + AT_HEADER_CRC + 4, BinarySnapshot::HEADER_SIZE - AT_HEADER_CRC - 4, crc);
+}
+
+const char* sectionName(BinarySnapshot::Section section) {
+    switch (section) {
+        case BinarySnapshot::Section::Books: return "книги";
+        case BinarySnapshot::Section::Members: return "абоненты";
+        case BinarySnapshot::Section::Loans: return "выдачи";
+        case BinarySnapshot::Section::Employees: return "работники";
+    }
+    return "?";
+}
+
+// Колонки раздела собираются целиком в памяти и дописываются в образ одним куском
+class TableWriter {
+private:
+    size_t rows;
+    size_t intCount;
+    size_t doubleCount;
+    size_t textCount;
+    std::vector<std::int32_t> ints;
+    std::vector<double> doubles;
+    std::vector<std::uint32_t> offsets;
+    std::string strings;
+
+public:
+    TableWriter(size_t pRows, size_t pIntCount, size_t pDoubleCount, size_t pTextCount)
+        : rows(pRows), intCount(pIntCount), doubleCount(pDoubleCount), textCount(pTextCount),
+          ints(pRows * pIntCount), doubles(pRows * pDoubleCount), offsets(pRows * pTextCount) {}
+
+    void setInt(size_t column, size_t row, std::int32_t value) { ints[column * rows + row] = value; }
+    void setDouble(size_t column, size_t row, double value) { doubles[column * rows + row] = value; }
+
+    void setText(size_t column, size_t row, std::string_view text) {
+        if (strings.size() + sizeof(std::uint32_t) + text.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw DataException("строки раздела снимка не помещаются в 4 ГБ");
+        }
+        offsets[column * rows + row] = static_cast<std::uint32_t>(strings.size());
+        append(strings, static_cast<std::uint32_t>(text.size()));
+        strings.append(text);
+    }
+
+    void appendTo(std::string& image) const {
+        append(image, static_cast<std::uint32_t>(rows));
+        append(image, static_cast<std::uint32_t>(intCount));
+        append(image, static_cast<std::uint32_t>(doubleCount));
+        append(image, static_cast<std::uint32_t>(textCount));
+        image.append(reinterpret_cast<const char*>(ints.data()), ints.size() * sizeof(std::int32_t));
+        alignTo8(image);
+        image.append(reinterpret_cast<const char*>(doubles.data()), doubles.size() * sizeof(double));
+        image.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint32_t));
+        image.append(strings);
+    }
+};
+
+// Минимальное число колонок каждого вида в разделе версии VERSION
+struct Layout {
+    BinarySnapshot::Section section;
+    size_t ints;
+    size_t doubles;
+    size_t texts;
+};
+
+constexpr Layout LAYOUTS[BinarySnapshot::SECTION_COUNT] = {
+    {BinarySnapshot::Section::Books, BinarySnapshot::BOOK_INTS, 0, BinarySnapshot::BOOK_TEXTS},
+    {BinarySnapshot::Section::Members, BinarySnapshot::MEMBER_INTS, 0, BinarySnapshot::MEMBER_TEXTS},
+    {BinarySnapshot::Section::Loans, BinarySnapshot::LOAN_INTS, 0, 0},
+    {BinarySnapshot::Section::Employees, BinarySnapshot::EMPLOYEE_INTS, BinarySnapshot::EMPLOYEE_DOUBLES, BinarySnapshot::EMPLOYEE_TEXTS},
+};
+}
+
+std::string_view BinarySnapshot::Table::getText(size_t column, size_t row) const {
+    auto offset = get<std::uint32_t>(offsets + (column * rows + row) * sizeof(std::uint32_t));
+    if (offset > stringsSize || stringsSize - offset < sizeof(std::uint32_t)) {
+        throw DataException("снимок: ссылка на строку за пределами раздела");
+    }
+    auto length = get<std::uint32_t>(strings + offset);
+    if (stringsSize - offset - sizeof(std::uint32_t) < length) {
+        throw DataException("снимок: строка выходит за пределы раздела");
+    }
+    return std::string_view(strings + offset + sizeof(std::uint32_t), length);
+}
+
+BinarySnapshot::BinarySnapshot(const std::string& path) : file(path) {
+    if (!file.isOpen()) {
+        return;
+    }
+    image = file.view();
+    const char* header = image.data();
+    if (image.size() < HEADER_SIZE || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        throw DataException("файл " + path + " не является снимком библиотеки");
+    }
+    if (auto version = get<std::uint32_t>(header + AT_VERSION); version != VERSION) {
+        throw DataException("снимок " + path + ": неподдерживаемая версия " + std::to_string(version));
+    }
+    if (get<std::uint32_t>(header + AT_BYTE_ORDER) != BYTE_ORDER_MARK) {
+        throw DataException("снимок " + path + " записан на машине с другим порядком байтов");
+    }
+    if (get<std::uint32_t>(header + AT_SECTION_COUNT) != SECTION_COUNT) {
+        throw DataException("снимок " + path + ": неверное число разделов");
+    }
+    if (get<std::uint32_t>(header + AT_HEADER_CRC) != headerCrc(header)) {
+        throw DataException("снимок " + path + ": повреждён заголовок");
+    }
+    if (get<std::uint64_t>(header + AT_FILE_SIZE) != image.size()) {
+        throw DataException("снимок " + path + ": размер файла не совпадает с заголовком (файл обрезан?)");
+    }
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        const char* entry = header + AT_SECTIONS + i * SECTION_ENTRY_SIZE;
+        auto offset = get<std::uint64_t>(entry + 8);
+        auto size = get<std::uint64_t>(entry + 16);
+        if (offset % 8 != 0 || offset < HEADER_SIZE || offset > image.size() || size > image.size() - offset) {
+            throw DataException("снимок " + path + ": раздел за пределами файла");
+        }
+    }
+    checkpoint = get<std::int32_t>(header + AT_CHECKPOINT);
+    nextBookId = get<std::int32_t>(header + AT_NEXT_BOOK_ID);
+    nextEmployeeId = get<std::int32_t>(header + AT_NEXT_EMPLOYEE_ID);
+}
+
+const char* BinarySnapshot::sectionEntry(Section section) const {
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        const char* entry = image.data() + AT_SECTIONS + i * SECTION_ENTRY_SIZE;
+        if (get<std::uint32_t>(entry) == static_cast<std::uint32_t>(section)) {
+            return entry;
+        }
+    }
+    throw DataException(std::string("снимок: нет раздела \"") + sectionName(section) + "\"");
+}
+
+void BinarySnapshot::verify() const {
+    for (const Layout& layout : LAYOUTS) {
+        const char* entry = sectionEntry(layout.section);
+        auto offset = get<std::uint64_t>(entry + 8);
+        auto size = get<std::uint64_t>(entry + 16);
+        if (crc32(image.data() + offset, size) != get<std::uint32_t>(entry + 4)) {
+            throw DataException(std::string("снимок: повреждён раздел \"") + sectionName(layout.section) + "\" (CRC)");
+        }
+    }
+}
+
+BinarySnapshot::Table BinarySnapshot::table(Section section) const {
+    const char* entry = sectionEntry(section);
+    const char* base = image.data() + get<std::uint64_t>(entry + 8);
+    auto size = get<std::uint64_t>(entry + 16);
+    auto fail = [section]() {
+        return DataException(std::string("снимок: неверная структура раздела \"") + sectionName(section) + "\"");
+    };
+    if (size < TABLE_HEADER_SIZE) {
+        throw fail();
+    }
+
+    Table result;
+    result.rows = get<std::uint32_t>(base);
+    auto intCount = get<std::uint32_t>(base + 4);
+    auto doubleCount = get<std::uint32_t>(base + 8);
+    auto textCount = get<std::uint32_t>(base + 12);
+    for (const Layout& layout : LAYOUTS) {
+        if (layout.section == section && (intCount < layout.ints || doubleCount < layout.doubles || textCount < layout.texts)) {
+            throw fail();
+        }
+    }
+    if (result.rows != get<std::uint64_t>(entry + 24)) {
+        throw fail();
+    }
+
+    // Размеры колонок считаются в 64 битах: переполнения при любых числах из файла нет
+    std::uint64_t rows = result.rows;
+    std::uint64_t intsEnd = TABLE_HEADER_SIZE + rows * intCount * sizeof(std::int32_t);
+    std::uint64_t doublesStart = (intsEnd + 7) / 8 * 8;
+    std::uint64_t offsetsStart = doublesStart + rows * doubleCount * sizeof(double);
+    std::uint64_t stringsStart = offsetsStart + rows * textCount * sizeof(std::uint32_t);
+    if (stringsStart > size) {
+        throw fail();
+    }
+    result.ints = base + TABLE_HEADER_SIZE;
+    result.doubles = base + doublesStart;
+    result.offsets = base + offsetsStart;
+    result.strings = base + stringsStart;
+    result.stringsSize = static_cast<size_t>(size - stringsStart);
+    return result;
+}
+
+void BinarySnapshot::setCheckpoint(std::string& header, int pCheckpoint) {
+    put(header, AT_CHECKPOINT, static_cast<std::int32_t>(pCheckpoint));
+    put(header, AT_HEADER_CRC, headerCrc(header.data()));
+}
+
+std::string BinarySnapshot::capture(const LibrarySystem& system) {
+    Contents contents;
+    contents.books.reserve(system.getBooks().size());
+    for (const Book& book : system.getBooks()) {
+        contents.books.push_back(&book);
+    }
+    contents.members.reserve(system.getMembers().size());
+    for (const LibraryMember& member : system.getMembers()) {
+        contents.members.push_back(&member);
+    }
+    contents.employees.reserve(system.getEmployees().size());
+    for (const Employee& emp : system.getEmployees()) {
+        contents.employees.push_back(&emp);
+    }
+    return capture(system, contents);
+}
+
+std::string BinarySnapshot::capture(const LibrarySystem& system, const Contents& contents) {
+    std::string image(HEADER_SIZE, '\0');
+    size_t sectionIndex = 0;
+    auto addSection = [&image, &sectionIndex](Section section, size_t rows, const TableWriter& writer) {
+        alignTo8(image);
+        size_t offset = image.size();
+        writer.appendTo(image);
+        size_t size = image.size() - offset;
+        size_t at = AT_SECTIONS + sectionIndex++ * SECTION_ENTRY_SIZE;
+        put(image, at, static_cast<std::uint32_t>(section));
+        put(image, at + 4, crc32(image.data() + offset, size));
+        put(image, at + 8, static_cast<std::uint64_t>(offset));
+        put(image, at + 16, static_cast<std::uint64_t>(size));
+        put(image, at + 24, static_cast<std::uint64_t>(rows));
+    };
+
+    TableWriter bookTable(contents.books.size(), BOOK_INTS, 0, BOOK_TEXTS);
+    size_t row = 0;
+    for (const Book* book : contents.books) {
+        bookTable.setInt(BOOK_ID, row, book->getId());
+        bookTable.setInt(BOOK_YEAR, row, book->getYear());
+        bookTable.setInt(BOOK_QUANTITY, row, book->getQuantity());
+        bookTable.setInt(BOOK_AVAILABLE, row, book->isAvailable() ? 1 : 0);
+        bookTable.setInt(BOOK_DISABLED, row, book->getManuallyDisabled() ? 1 : 0);
+        bookTable.setText(BOOK_TITLE, row, book->getTitle());
+        bookTable.setText(BOOK_AUTHOR, row, book->getAuthor());
+        bookTable.setText(BOOK_ISBN, row, book->getIsbn());
+        bookTable.setText(BOOK_GENRE, row, book->getGenre());
+        bookTable.setText(BOOK_COVER, row, book->getCoverPath());
+        bookTable.setText(BOOK_DESCRIPTION, row, book->getDescription());
+        bookTable.setText(BOOK_PDF, row, book->getPdfPath());
+        ++row;
+    }
+    addSection(Section::Books, contents.books.size(), bookTable);
+
+    // Выдачи - в порядке абонентов и их историй, как в members.txt
+    const LoanStore& loans = system.getLoanStore();
+    size_t loanCount = 0;
+    TableWriter memberTable(contents.members.size(), MEMBER_INTS, 0, MEMBER_TEXTS);
+    row = 0;
+    for (const LibraryMember* member : contents.members) {
+        memberTable.setInt(MEMBER_ID, row, member->getId());
+        memberTable.setInt(MEMBER_BLOCKED, row, member->getIsBlocked() ? 1 : 0);
+        memberTable.setText(MEMBER_NAME, row, member->getName());
+        memberTable.setText(MEMBER_SURNAME, row, member->getSurname());
+        memberTable.setText(MEMBER_PHONE, row, member->getPhone());
+        memberTable.setText(MEMBER_EMAIL, row, member->getEmail());
+        loanCount += loans.getMemberLoans(member->getId()).size();
+        ++row;
+    }
+    addSection(Section::Members, contents.members.size(), memberTable);
+
+    TableWriter loanTable(loanCount, LOAN_INTS, 0, 0);
+    row = 0;
+    for (const LibraryMember* member : contents.members) {
+        for (LoanStore::LoanId loanId : loans.getMemberLoans(member->getId())) {
+            const BorrowedBook& loan = loans.get(loanId);
+            loanTable.setInt(LOAN_MEMBER, row, member->getId());
+            loanTable.setInt(LOAN_BOOK, row, loan.bookId);
+            loanTable.setInt(LOAN_BORROWED, row, loan.borrowDate.toDays());
+            loanTable.setInt(LOAN_DUE, row, loan.returnDate.toDays());
+            loanTable.setInt(LOAN_RETURNED, row, loan.returned ? 1 : 0);
+            loanTable.setInt(LOAN_EMPLOYEE, row, loan.employeeId);
+            ++row;
+        }
+    }
+    addSection(Section::Loans, loanCount, loanTable);
+
+    TableWriter employeeTable(contents.employees.size(), EMPLOYEE_INTS, EMPLOYEE_DOUBLES, EMPLOYEE_TEXTS);
+    row = 0;
+    for (const Employee* emp : contents.employees) {
+        employeeTable.setInt(EMPLOYEE_ID, row, emp->getId());
+        employeeTable.setInt(EMPLOYEE_HOURS, row, emp->getWorkHours());
+        employeeTable.setInt(EMPLOYEE_LIBRARIAN, row, emp->getPositionKey() == Librarian::positionKey() ? 1 : 0);
+        employeeTable.setDouble(EMPLOYEE_SALARY, row, emp->getSalary());
+        employeeTable.setText(EMPLOYEE_NAME, row, emp->getName());
+        employeeTable.setText(EMPLOYEE_SURNAME, row, emp->getSurname());
+        employeeTable.setText(EMPLOYEE_PHONE, row, emp->getPhone());
+        ++row;
+    }
+    addSection(Section::Employees, contents.employees.size(), employeeTable);
+
+    std::memcpy(image.data(), MAGIC, sizeof(MAGIC));
+    put(image, AT_VERSION, VERSION);
+    put(image, AT_BYTE_ORDER, BYTE_ORDER_MARK);
+    put(image, AT_SECTION_COUNT, static_cast<std::uint32_t>(SECTION_COUNT));
+    put(image, AT_NEXT_BOOK_ID, static_cast<std::int32_t>(system.getNextBookId()));
+    put(image, AT_NEXT_EMPLOYEE_ID, static_cast<std::int32_t>(system.getNextEmployeeId()));
+    put(image, AT_FILE_SIZE, static_cast<std::uint64_t>(image.size()));
+    setCheckpoint(image, 0);
+    return image;
+}
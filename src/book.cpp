@@ -5,16 +5,47 @@ Book::Book(int pId, std::string_view pTitle, std::string_view pAuthor,
            std::string_view pIsbn, int pYear, std::string_view pGenre, 
            std::string_view pCoverPath, int pQuantity,
            std::string_view pDescription, std::string_view pPdfPath)
-    : Item(pId, pTitle), author(pAuthor), isbn(pIsbn), year(pYear), genre(pGenre), 
-      coverPath(pCoverPath), quantity(pQuantity), description(pDescription), 
-      pdfPath(pPdfPath) {
+    : Item(pId, pTitle), year(pYear), totalCopies(pQuantity), author(pAuthor), genre(pGenre), isbn(pIsbn) {
+    setCoverPath(pCoverPath);
+    setDescription(pDescription);
+    setPdfPath(pPdfPath);
+}
+
+const BookDetails& Book::getDetails() const {
+    static const BookDetails empty;
+    return details ? *details : empty;
+}
+
+BookDetails& Book::editDetails() {
+    if (!details) {
+        details = std::make_unique<BookDetails>();
+    }
+    return *details;
+}
+
+void Book::setCoverPath(std::string_view pCoverPath) {
+    if (details || !pCoverPath.empty()) {
+        editDetails().coverPath = pCoverPath;
+    }
+}
+
+void Book::setDescription(std::string_view pDescription) {
+    if (details || !pDescription.empty()) {
+        editDetails().description = pDescription;
+    }
+}
+
+void Book::setPdfPath(std::string_view pPdfPath) {
+    if (details || !pPdfPath.empty()) {
+        editDetails().pdfPath = pPdfPath;
+    }
 }
 
 std::string Book::getInfo() const {
     std::ostringstream oss;
-    oss << "ID: " << getId() << ", " << getTitle() << " by " << author 
+    oss << "ID: " << getId() << ", " << getTitle() << " by " << author.str() 
         << ", ISBN: " << isbn << ", Year: " << year 
-        << ", Genre: " << genre 
+        << ", Genre: " << genre.str() 
         << ", Available: " << (isAvailable() ? "Yes" : "No");
     return oss.str();
 }
@@ -0,0 +1,120 @@
+#include "bufferedwriter.h"
+#include "exceptions.h"
+#include <charconv>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+BufferedWriter::BufferedWriter(std::string_view pPath)
+    : path(pPath), file(path, std::ios::binary | std::ios::trunc), buffer(new char[BUFFER_SIZE]) {
+    if (!file.is_open()) {
+        throw FileException("Не удалось открыть файл: " + path);
+    }
+}
+
+BufferedWriter::BufferedWriter(std::string* target) : memory(target), buffer(new char[BUFFER_SIZE]) {}
+
+BufferedWriter::~BufferedWriter() {
+    if (memory) {
+        memory->append(buffer.get(), used);
+    } else if (file.is_open()) {
+        file.write(buffer.get(), static_cast<std::streamsize>(used));
+    }
+}
+
+void BufferedWriter::flushBuffer() {
+    if (used == 0) return;
+    if (memory) {
+        memory->append(buffer.get(), used);
+        used = 0;
+        return;
+    }
+    file.write(buffer.get(), static_cast<std::streamsize>(used));
+    used = 0;
+    if (!file) {
+        throw FileException("Ошибка записи в файл: " + path);
+    }
+}
+
+char* BufferedWriter::reserve(size_t count) {
+    if (used + count > BUFFER_SIZE) {
+        flushBuffer();
+    }
+    return buffer.get() + used;
+}
+
+BufferedWriter& BufferedWriter::operator<<(std::string_view text) {
+    if (text.size() > BUFFER_SIZE) { // Длинные строки - напрямую, минуя буфер
+        flushBuffer();
+        if (memory) {
+            memory->append(text);
+            return *this;
+        }
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!file) {
+            throw FileException("Ошибка записи в файл: " + path);
+        }
+        return *this;
+    }
+    std::memcpy(reserve(text.size()), text.data(), text.size());
+    used += text.size();
+    return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(char c) {
+    *reserve(1) = c;
+    ++used;
+    return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(int value) {
+    constexpr size_t MAX_LENGTH = 16;
+    char* out = reserve(MAX_LENGTH);
+    used = static_cast<size_t>(std::to_chars(out, out + MAX_LENGTH, value).ptr - buffer.get());
+    return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(double value) {
+#if defined(__cpp_lib_to_chars)
+    // Кратчайшая запись, которая читается обратно (std::from_chars) без потерь
+    constexpr size_t MAX_LENGTH = 32;
+    char* out = reserve(MAX_LENGTH);
+    used = static_cast<size_t>(std::to_chars(out, out + MAX_LENGTH, value).ptr - buffer.get());
+    return *this;
+#else
+    // std::to_chars для double есть не везде (libc++ в Apple clang, GCC до 11).
+    // Короткая запись (digits10 цифр), если она читается обратно без потерь, иначе
+    // max_digits10 цифр. Потоки с локалью "C" - десятичный разделитель всегда точка
+    std::ostringstream stream;
+    stream.imbue(std::locale::classic());
+    stream << std::setprecision(std::numeric_limits<double>::digits10) << value;
+    std::istringstream check(stream.str());
+    check.imbue(std::locale::classic());
+    double parsed = 0;
+    if (!(check >> parsed) || parsed != value) {
+        stream.str(std::string());
+        stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    }
+    return *this << std::string_view(stream.str());
+#endif
+}
+
+BufferedWriter& BufferedWriter::operator<<(Date date) {
+    char* out = reserve(Date::ISO_LENGTH);
+    used = static_cast<size_t>(date.formatTo(out) - buffer.get());
+    return *this;
+}
+
+void BufferedWriter::close() {
+    flushBuffer();
+    if (memory) {
+        memory = nullptr; // Дальнейшая запись в строку не ожидается
+        return;
+    }
+    file.close();
+    if (file.fail()) {
+        throw FileException("Ошибка записи в файл: " + path);
+    }
+}
@@ -0,0 +1,463 @@
+#include "catalogcolumns.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
+namespace {
+// Заглавные буквы с одинаковым сдвигом к строчной паре
+struct CaseRange {
+    char32_t first;
+    char32_t last;
+    int delta; // Строчная = заглавная + delta
+    int step; // 1 - заглавные все буквы диапазона, 2 - через одну (пары "заглавная, строчная")
+};
+
+// Простые (однобуквенные) строчные пары Unicode 14 вне ASCII - те же, что у QString::toLower.
+// Составлено по UnicodeData.txt; İ (U+0130) приводится к i. По возрастанию first
+constexpr CaseRange CASE_RANGES[] = {
+    // Латиница-1
+    {0x00C0, 0x00D6, 32, 1},
+    {0x00D8, 0x00DE, 32, 1},
+    // Латиница, расширенная A и B
+    {0x0100, 0x012E, 1, 2},
+    {0x0130, 0x0130, -199, 1},
+    {0x0132, 0x0136, 1, 2},
+    {0x0139, 0x0147, 1, 2},
+    {0x014A, 0x0176, 1, 2},
+    {0x0178, 0x0178, -121, 1},
+    {0x0179, 0x017D, 1, 2},
+    {0x0181, 0x0181, 210, 1},
+    {0x0182, 0x0184, 1, 2},
+    {0x0186, 0x0186, 206, 1},
+    {0x0187, 0x0187, 1, 1},
+    {0x0189, 0x018A, 205, 1},
+    {0x018B, 0x018B, 1, 1},
+    {0x018E, 0x018E, 79, 1},
+    {0x018F, 0x018F, 202, 1},
+    {0x0190, 0x0190, 203, 1},
+    {0x0191, 0x0191, 1, 1},
+    {0x0193, 0x0193, 205, 1},
+    {0x0194, 0x0194, 207, 1},
+    {0x0196, 0x0196, 211, 1},
+    {0x0197, 0x0197, 209, 1},
+    {0x0198, 0x0198, 1, 1},
+    {0x019C, 0x019C, 211, 1},
+    {0x019D, 0x019D, 213, 1},
+    {0x019F, 0x019F, 214, 1},
+    {0x01A0, 0x01A4, 1, 2},
+    {0x01A6, 0x01A6, 218, 1},
+    {0x01A7, 0x01A7, 1, 1},
+    {0x01A9, 0x01A9, 218, 1},
+    {0x01AC, 0x01AC, 1, 1},
+    {0x01AE, 0x01AE, 218, 1},
+    {0x01AF, 0x01AF, 1, 1},
+    {0x01B1, 0x01B2, 217, 1},
+    {0x01B3, 0x01B5, 1, 2},
+    {0x01B7, 0x01B7, 219, 1},
+    {0x01B8, 0x01B8, 1, 1},
+    {0x01BC, 0x01BC, 1, 1},
+    {0x01C4, 0x01C4, 2, 1},
+    {0x01C5, 0x01C5, 1, 1},
+    {0x01C7, 0x01C7, 2, 1},
+    {0x01C8, 0x01C8, 1, 1},
+    {0x01CA, 0x01CA, 2, 1},
+    {0x01CB, 0x01DB, 1, 2},
+    {0x01DE, 0x01EE, 1, 2},
+    {0x01F1, 0x01F1, 2, 1},
+    {0x01F2, 0x01F4, 1, 2},
+    {0x01F6, 0x01F6, -97, 1},
+    {0x01F7, 0x01F7, -56, 1},
+    {0x01F8, 0x021E, 1, 2},
+    {0x0220, 0x0220, -130, 1},
+    {0x0222, 0x0232, 1, 2},
+    {0x023A, 0x023A, 10795, 1},
+    {0x023B, 0x023B, 1, 1},
+    {0x023D, 0x023D, -163, 1},
+    {0x023E, 0x023E, 10792, 1},
+    {0x0241, 0x0241, 1, 1},
+    {0x0243, 0x0243, -195, 1},
+    {0x0244, 0x0244, 69, 1},
+    {0x0245, 0x0245, 71, 1},
+    {0x0246, 0x024E, 1, 2},
+    // Греческий и коптский
+    {0x0370, 0x0372, 1, 2},
+    {0x0376, 0x0376, 1, 1},
+    {0x037F, 0x037F, 116, 1},
+    {0x0386, 0x0386, 38, 1},
+    {0x0388, 0x038A, 37, 1},
+    {0x038C, 0x038C, 64, 1},
+    {0x038E, 0x038F, 63, 1},
+    {0x0391, 0x03A1, 32, 1},
+    {0x03A3, 0x03AB, 32, 1},
+    {0x03CF, 0x03CF, 8, 1},
+    {0x03D8, 0x03EE, 1, 2},
+    {0x03F4, 0x03F4, -60, 1},
+    {0x03F7, 0x03F7, 1, 1},
+    {0x03F9, 0x03F9, -7, 1},
+    {0x03FA, 0x03FA, 1, 1},
+    {0x03FD, 0x03FF, -130, 1},
+    // Кириллица
+    {0x0400, 0x040F, 80, 1},
+    {0x0410, 0x042F, 32, 1},
+    {0x0460, 0x0480, 1, 2},
+    {0x048A, 0x04BE, 1, 2},
+    {0x04C0, 0x04C0, 15, 1},
+    {0x04C1, 0x04CD, 1, 2},
+    {0x04D0, 0x052E, 1, 2},
+    // Армянский
+    {0x0531, 0x0556, 48, 1},
+    // Грузинский
+    {0x10A0, 0x10C5, 7264, 1},
+    {0x10C7, 0x10C7, 7264, 1},
+    {0x10CD, 0x10CD, 7264, 1},
+    // Чероки
+    {0x13A0, 0x13EF, 38864, 1},
+    {0x13F0, 0x13F5, 8, 1},
+    // Грузинский (мтаврули)
+    {0x1C90, 0x1CBA, -3008, 1},
+    {0x1CBD, 0x1CBF, -3008, 1},
+    // Латиница, дополнительная (вьетнамский и др.)
+    {0x1E00, 0x1E94, 1, 2},
+    {0x1E9E, 0x1E9E, -7615, 1},
+    {0x1EA0, 0x1EFE, 1, 2},
+    // Греческий расширенный
+    {0x1F08, 0x1F0F, -8, 1},
+    {0x1F18, 0x1F1D, -8, 1},
+    {0x1F28, 0x1F2F, -8, 1},
+    {0x1F38, 0x1F3F, -8, 1},
+    {0x1F48, 0x1F4D, -8, 1},
+    {0x1F59, 0x1F5F, -8, 2},
+    {0x1F68, 0x1F6F, -8, 1},
+    {0x1F88, 0x1F8F, -8, 1},
+    {0x1F98, 0x1F9F, -8, 1},
+    {0x1FA8, 0x1FAF, -8, 1},
+    {0x1FB8, 0x1FB9, -8, 1},
+    {0x1FBA, 0x1FBB, -74, 1},
+    {0x1FBC, 0x1FBC, -9, 1},
+    {0x1FC8, 0x1FCB, -86, 1},
+    {0x1FCC, 0x1FCC, -9, 1},
+    {0x1FD8, 0x1FD9, -8, 1},
+    {0x1FDA, 0x1FDB, -100, 1},
+    {0x1FE8, 0x1FE9, -8, 1},
+    {0x1FEA, 0x1FEB, -112, 1},
+    {0x1FEC, 0x1FEC, -7, 1},
+    {0x1FF8, 0x1FF9, -128, 1},
+    {0x1FFA, 0x1FFB, -126, 1},
+    {0x1FFC, 0x1FFC, -9, 1},
+    // Буквоподобные символы, римские цифры, буквы в кружках
+    {0x2126, 0x2126, -7517, 1},
+    {0x212A, 0x212A, -8383, 1},
+    {0x212B, 0x212B, -8262, 1},
+    {0x2132, 0x2132, 28, 1},
+    {0x2160, 0x216F, 16, 1},
+    {0x2183, 0x2183, 1, 1},
+    {0x24B6, 0x24CF, 26, 1},
+    // Глаголица, латиница C, коптский
+    {0x2C00, 0x2C2F, 48, 1},
+    {0x2C60, 0x2C60, 1, 1},
+    {0x2C62, 0x2C62, -10743, 1},
+    {0x2C63, 0x2C63, -3814, 1},
+    {0x2C64, 0x2C64, -10727, 1},
+    {0x2C67, 0x2C6B, 1, 2},
+    {0x2C6D, 0x2C6D, -10780, 1},
+    {0x2C6E, 0x2C6E, -10749, 1},
+    {0x2C6F, 0x2C6F, -10783, 1},
+    {0x2C70, 0x2C70, -10782, 1},
+    {0x2C72, 0x2C72, 1, 1},
+    {0x2C75, 0x2C75, 1, 1},
+    {0x2C7E, 0x2C7F, -10815, 1},
+    {0x2C80, 0x2CE2, 1, 2},
+    {0x2CEB, 0x2CED, 1, 2},
+    {0x2CF2, 0x2CF2, 1, 1},
+    // Кириллица B, латиница D
+    {0xA640, 0xA66C, 1, 2},
+    {0xA680, 0xA69A, 1, 2},
+    {0xA722, 0xA72E, 1, 2},
+    {0xA732, 0xA76E, 1, 2},
+    {0xA779, 0xA77B, 1, 2},
+    {0xA77D, 0xA77D, -35332, 1},
+    {0xA77E, 0xA786, 1, 2},
+    {0xA78B, 0xA78B, 1, 1},
+    {0xA78D, 0xA78D, -42280, 1},
+    {0xA790, 0xA792, 1, 2},
+    {0xA796, 0xA7A8, 1, 2},
+    {0xA7AA, 0xA7AA, -42308, 1},
+    {0xA7AB, 0xA7AB, -42319, 1},
+    {0xA7AC, 0xA7AC, -42315, 1},
+    {0xA7AD, 0xA7AD, -42305, 1},
+    {0xA7AE, 0xA7AE, -42308, 1},
+    {0xA7B0, 0xA7B0, -42258, 1},
+    {0xA7B1, 0xA7B1, -42282, 1},
+    {0xA7B2, 0xA7B2, -42261, 1},
+    {0xA7B3, 0xA7B3, 928, 1},
+    {0xA7B4, 0xA7C2, 1, 2},
+    {0xA7C4, 0xA7C4, -48, 1},
+    {0xA7C5, 0xA7C5, -42307, 1},
+    {0xA7C6, 0xA7C6, -35384, 1},
+    {0xA7C7, 0xA7C9, 1, 2},
+    {0xA7D0, 0xA7D0, 1, 1},
+    {0xA7D6, 0xA7D8, 1, 2},
+    {0xA7F5, 0xA7F5, 1, 1},
+    // Полноширинная латиница
+    {0xFF21, 0xFF3A, 32, 1},
+    // Прочие алфавиты вне BMP
+    {0x10400, 0x10427, 40, 1},
+    {0x104B0, 0x104D3, 40, 1},
+    {0x10570, 0x1057A, 39, 1},
+    {0x1057C, 0x1058A, 39, 1},
+    {0x1058C, 0x10592, 39, 1},
+    {0x10594, 0x10595, 39, 1},
+    {0x10C80, 0x10CB2, 64, 1},
+    {0x118A0, 0x118BF, 32, 1},
+    {0x16E40, 0x16E5F, 32, 1},
+    {0x1E900, 0x1E921, 34, 1},
+};
+
+char32_t lowerLetter(char32_t letter) {
+    // Самый частый случай в каталоге - кириллица: без поиска по таблице
+    if (letter >= 0x430 && letter <= 0x45F) {
+        return letter;
+    }
+    if (letter >= 0x410 && letter <= 0x42F) {
+        return letter + 0x20;
+    }
+    const CaseRange* range = std::upper_bound(std::begin(CASE_RANGES), std::end(CASE_RANGES), letter,
+                                              [](char32_t value, const CaseRange& r) { return value < r.first; });
+    if (range == std::begin(CASE_RANGES)) {
+        return letter;
+    }
+    --range;
+    if (letter > range->last || (letter - range->first) % range->step != 0) {
+        return letter;
+    }
+    return static_cast<char32_t>(static_cast<std::int32_t>(letter) + range->delta);
+}
+
+// Длина символа UTF-8 по первому байту; 0 - байт не начинает символ
+size_t sequenceLength(unsigned char lead) {
+    if ((lead & 0xE0) == 0xC0) return 2;
+    if ((lead & 0xF0) == 0xE0) return 3;
+    if ((lead & 0xF8) == 0xF0) return 4;
+    return 0;
+}
+
+// Запись символа в UTF-8; возвращает число байтов
+size_t encodeUtf8(char32_t letter, char* out) {
+    if (letter < 0x80) {
+        out[0] = static_cast<char>(letter);
+        return 1;
+    }
+    if (letter < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (letter >> 6));
+        out[1] = static_cast<char>(0x80 | (letter & 0x3F));
+        return 2;
+    }
+    if (letter < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (letter >> 12));
+        out[1] = static_cast<char>(0x80 | ((letter >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (letter & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (letter >> 18));
+    out[1] = static_cast<char>(0x80 | ((letter >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((letter >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (letter & 0x3F));
+    return 4;
+}
+}
+
+std::string foldCase(std::string_view text) {
+    std::string result(text);
+    for (size_t i = 0; i < result.size();) {
+        auto c = static_cast<unsigned char>(result[i]);
+        if (c < 0x80) {
+            if (c >= 'A' && c <= 'Z') {
+                result[i] = static_cast<char>(c + ('a' - 'A'));
+            }
+            ++i;
+            continue;
+        }
+        size_t length = sequenceLength(c);
+        bool valid = length > 0 && i + length <= result.size();
+        char32_t letter = c & (0x7F >> length);
+        for (size_t k = 1; valid && k < length; ++k) {
+            auto next = static_cast<unsigned char>(result[i + k]);
+            valid = (next & 0xC0) == 0x80;
+            letter = (letter << 6) | (next & 0x3F);
+        }
+        if (!valid) { // Не UTF-8 - байт как есть
+            ++i;
+            continue;
+        }
+        if (char32_t lower = lowerLetter(letter); lower != letter) {
+            // Обычно длина та же; у немногих пар другая (İ -> i, Ⱥ -> ⱥ) - тогда остаток сдвигается
+            char encoded[4];
+            size_t encodedLength = encodeUtf8(lower, encoded);
+            if (encodedLength == length) {
+                std::copy(encoded, encoded + length, result.begin() + i);
+            } else {
+                result.replace(i, length, encoded, encodedLength);
+                length = encodedLength;
+            }
+        }
+        i += length;
+    }
+    return result;
+}
+
+void CatalogColumns::setBit(std::vector<Word>& bits, size_t row, bool value) {
+    Word mask = Word(1) << (row % WORD_BITS);
+    if (value) {
+        bits[row / WORD_BITS] |= mask;
+    } else {
+        bits[row / WORD_BITS] &= ~mask;
+    }
+}
+
+void CatalogColumns::append(const Book& book) {
+    appendEmpty();
+    update(years.size() - 1, book);
+}
+
+void CatalogColumns::appendEmpty() {
+    size_t row = years.size();
+    years.push_back(0);
+    titles.appendEmpty();
+    authors.appendEmpty();
+    isbns.appendEmpty();
+    genres.emplace_back();
+    if (row % WORD_BITS == 0) {
+        liveBits.push_back(0);
+        availableBits.push_back(0);
+    }
+}
+
+void CatalogColumns::update(size_t row, const Book& book) {
+    years[row] = book.getYear();
+    titles.set(row, foldCase(book.getTitle()));
+    authors.set(row, foldCase(book.getAuthor()));
+    isbns.set(row, foldCase(book.getIsbn()));
+    genres[row] = book.getGenreKey();
+    setBit(liveBits, row, true);
+    setBit(availableBits, row, book.isAvailable());
+}
+
+void CatalogColumns::setAvailable(size_t row, bool available) {
+    setBit(availableBits, row, available);
+}
+
+void CatalogColumns::erase(size_t row) {
+    years[row] = 0;
+    titles.set(row, std::string());
+    authors.set(row, std::string());
+    isbns.set(row, std::string());
+    genres[row] = InternedString();
+    setBit(liveBits, row, false);
+    setBit(availableBits, row, false);
+}
+
+void CatalogColumns::clear() {
+    years.clear();
+    liveBits.clear();
+    availableBits.clear();
+    titles.clear();
+    authors.clear();
+    isbns.clear();
+    genres.clear();
+}
+
+void CatalogColumns::reserve(size_t count) {
+    years.reserve(count);
+    liveBits.reserve(count / WORD_BITS + 1);
+    availableBits.reserve(count / WORD_BITS + 1);
+    titles.reserve(count);
+    authors.reserve(count);
+    isbns.reserve(count);
+    genres.reserve(count);
+}
+
+void CatalogColumns::filterYears(std::vector<Word>& mask, int yearFrom, int yearTo) const {
+    // Без ограничения сверху/снизу - весь диапазон int
+    int low = (yearFrom > 0) ? yearFrom : std::numeric_limits<int>::min();
+    int high = (yearTo > 0) ? yearTo : std::numeric_limits<int>::max();
+    const size_t rows = years.size();
+    for (size_t w = 0; w < mask.size(); ++w) {
+        if (mask[w] == 0) continue;
+        size_t first = w * WORD_BITS;
+        size_t count = (rows - first < WORD_BITS) ? rows - first : WORD_BITS;
+        Word bits = 0;
+        for (size_t b = 0; b < count; ++b) {
+            int year = years[first + b];
+            bits |= Word(year >= low && year <= high) << b;
+        }
+        mask[w] &= bits;
+    }
+}
+
+void CatalogColumns::filterInterned(std::vector<Word>& mask, const std::vector<InternedString>& column, std::string_view needle) {
+    // Результат проверки подстроки для каждого значения пула: -1 - ещё не проверялось
+    std::vector<signed char> matches(InternedString::poolSize(), -1);
+    for (size_t w = 0; w < mask.size(); ++w) {
+        Word bits = mask[w];
+        while (bits != 0) {
+            Word lowest = bits & (~bits + 1);
+            const InternedString& value = column[w * WORD_BITS + lowestBit(bits)];
+            signed char& match = matches[value.getId()];
+            if (match < 0) {
+                match = (foldCase(value.str()).find(needle) != std::string::npos) ? 1 : 0;
+            }
+            if (match == 0) {
+                mask[w] &= ~lowest;
+            }
+            bits &= bits - 1;
+        }
+    }
+}
+
+std::vector<size_t> CatalogColumns::select(const Query& query, const std::vector<size_t>* candidates) const {
+    std::vector<Word> mask = liveBits;
+    if (candidates) {
+        std::vector<Word> selected(mask.size(), 0);
+        for (size_t row : *candidates) {
+            selected[row / WORD_BITS] |= Word(1) << (row % WORD_BITS);
+        }
+        for (size_t w = 0; w < mask.size(); ++w) {
+            mask[w] &= selected[w];
+        }
+    }
+
+    // Сначала дешёвые фильтры по плотным колонкам, затем строки - только для оставшихся
+    if (query.availability == 1) {
+        for (size_t w = 0; w < mask.size(); ++w) {
+            mask[w] &= availableBits[w];
+        }
+    } else if (query.availability == 0) {
+        for (size_t w = 0; w < mask.size(); ++w) {
+            mask[w] &= ~availableBits[w];
+        }
+    }
+    if (query.yearFrom > 0 || query.yearTo > 0) {
+        filterYears(mask, query.yearFrom, query.yearTo);
+    }
+    if (!query.title.empty()) {
+        titles.filter(mask, foldCase(query.title));
+    }
+    if (!query.author.empty()) {
+        authors.filter(mask, foldCase(query.author));
+    }
+    if (!query.genre.empty()) {
+        filterInterned(mask, genres, foldCase(query.genre));
+    }
+    if (!query.isbn.empty()) {
+        isbns.filter(mask, foldCase(query.isbn));
+    }
+
+    std::vector<size_t> rows;
+    for (size_t w = 0; w < mask.size(); ++w) {
+        for (Word bits = mask[w]; bits != 0; bits &= bits - 1) {
+            rows.push_back(w * WORD_BITS + lowestBit(bits));
+        }
+    }
+    return rows;
+}
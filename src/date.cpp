@@ -0,0 +1,19 @@
+#include "date.h"
+#include <ctime>
+
+static_assert(sizeof(Date) == 4, "Date должна занимать 4 байта");
+static_assert(Date::fromCivil(1970, 1, 1).toDays() == 0);
+static_assert(Date::parse("2000-03-01")->toDays() == 11017);
+static_assert(!Date::parse("2023-02-29").has_value());
+
+Date Date::today() {
+    time_t now = time(nullptr);
+    struct tm timeinfo;
+#ifdef _WIN32
+    localtime_s(&timeinfo, &now);
+#else
+    localtime_r(&now, &timeinfo);
+#endif
+    return fromCivil(timeinfo.tm_year + 1900, static_cast<unsigned>(timeinfo.tm_mon + 1),
+                     static_cast<unsigned>(timeinfo.tm_mday));
+}
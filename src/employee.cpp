@@ -2,7 +2,7 @@
 #include <sstream>
 
 Employee::Employee(int pId, std::string_view pName, std::string_view pSurname,
-                   std::string_view pPhone, std::string_view pPosition, double pSalary, int pWorkHours)
+                   std::string_view pPhone, InternedString pPosition, double pSalary, int pWorkHours)
     : Person(pId, pName, pSurname, pPhone), position(pPosition), salary(pSalary), workHours(pWorkHours) {
 }
 
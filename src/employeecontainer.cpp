@@ -0,0 +1,79 @@
+#include "employeecontainer.h"
+#include "exceptions.h"
+
+namespace {
+// Пустые слоты убираются, когда их больше половины (но не раньше этого порога)
+constexpr size_t MIN_HOLES_TO_COMPACT = 64;
+
+template<typename T>
+void eraseFromRole(std::vector<T*>& role, const Employee* employee) {
+    auto it = std::find(role.begin(), role.end(), employee);
+    if (it != role.end()) {
+        role.erase(it);
+    }
+}
+}
+
+void EmployeeContainer::addEmployee(std::unique_ptr<Employee> employee) {
+    if (idIndex.contains(employee->getId())) {
+        throw DuplicateException("Работник с ID " + std::to_string(employee->getId()) + " уже существует");
+    }
+    if (auto* lib = dynamic_cast<Librarian*>(employee.get())) {
+        librarians.push_back(lib);
+    } else if (auto* mgr = dynamic_cast<Manager*>(employee.get())) {
+        managers.push_back(mgr);
+    }
+    idIndex.insert(employee->getId(), employees.size());
+    nameIndex.set(employee->getId(), employee->getName() + " " + employee->getSurname());
+    employees.push_back(std::move(employee));
+}
+
+void EmployeeContainer::removeEmployee(int id) {
+    size_t pos = idIndex.find(id);
+    if (pos == IdIndex::npos) {
+        throw NotFoundException("Работник с ID " + std::to_string(id));
+    }
+    eraseFromRole(librarians, employees[pos].get());
+    eraseFromRole(managers, employees[pos].get());
+    employees[pos].reset();
+    nameIndex.erase(id);
+    idIndex.erase(id);
+    ++holes;
+    if (holes >= MIN_HOLES_TO_COMPACT && holes * 2 > employees.size()) {
+        compact();
+    }
+}
+
+void EmployeeContainer::compact() {
+    auto newEnd = std::remove(employees.begin(), employees.end(), nullptr);
+    employees.erase(newEnd, employees.end());
+    holes = 0;
+    for (size_t i = 0; i < employees.size(); ++i) {
+        idIndex.insert(employees[i]->getId(), i);
+    }
+}
+
+void EmployeeContainer::syncEmployee(int id) {
+    if (const Employee* employee = findEmployee(id)) {
+        nameIndex.set(id, employee->getName() + " " + employee->getSurname());
+    }
+}
+
+std::vector<Employee*> EmployeeContainer::suggestEmployees(std::string_view prefix, size_t limit) const {
+    std::vector<Employee*> result;
+    for (int id : nameIndex.find(prefix, limit)) {
+        result.push_back(findEmployee(id));
+    }
+    return result;
+}
+
+std::vector<Employee*> EmployeeContainer::getAllEmployees() const {
+    std::vector<Employee*> result;
+    result.reserve(size());
+    for (const auto& employee : employees) {
+        if (employee) {
+            result.push_back(employee.get());
+        }
+    }
+    return result;
+}
@@ -1,309 +1,1053 @@
 #include "filemanager.h"
 #include "exceptions.h"
-#include <sstream>
+#include "mappedfile.h"
+#include "bufferedwriter.h"
+#include "journal.h"
+#include "binarysnapshot.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <locale>
+#include <sstream>
 
-void FileManager::saveLibrarySystem(const LibrarySystem& system, std::string_view basePath) {
-    try {
-        std::string basePathStr(basePath);
-        saveBooks(system, basePathStr + "/books.txt");
-        saveMembers(system, basePathStr + "/members.txt");
-        saveEmployees(system, basePathStr + "/employees.txt");
-        saveMetadata(system, basePathStr + "/metadata.txt");
-    } catch (const std::exception& e) {
-        throw FileException("Не удалось сохранить систему библиотеки: " + std::string(e.what()));
+namespace {
+// Построчный обход текста без копирования: строки - участки отображённого файла
+class LineReader {
+private:
+    std::string_view rest;
+    size_t number = 0;
+
+public:
+    explicit LineReader(std::string_view text) : rest(text) {}
+
+    bool next(std::string_view& line) {
+        if (rest.empty()) return false;
+        const auto* newline = static_cast<const char*>(std::memchr(rest.data(), '\n', rest.size()));
+        size_t length = newline ? static_cast<size_t>(newline - rest.data()) : rest.size();
+        line = rest.substr(0, length);
+        rest.remove_prefix(newline ? length + 1 : length);
+        if (!line.empty() && line.back() == '\r') { // Файлы, сохранённые с переводами строк Windows
+            line.remove_suffix(1);
+        }
+        ++number;
+        return true;
     }
-}
 
-void FileManager::loadLibrarySystem(LibrarySystem& system, std::string_view basePath) {
-    try {
-        std::string basePathStr(basePath);
-        // Сначала загружаем метаданные (ID счетчики)
-        loadMetadata(system, basePathStr + "/metadata.txt");
-        // Затем загружаем книги
-        loadBooks(system, basePathStr + "/books.txt");
-        // Затем загружаем абонентов (без взятых книг)
-        loadMembers(system, basePathStr + "/members.txt");
-        // Затем загружаем работников
-        loadEmployees(system, basePathStr + "/employees.txt");
-        // В конце загружаем взятые книги (нужно загружать после книг и абонентов)
-        loadBorrowedBooks(system, basePathStr + "/members.txt");
-        
-        // Обновляем доступность всех книг после загрузки всех данных
-        auto allBooks = system.getAllBooks();
-        for (const auto* book : allBooks) {
-            system.updateBookAvailability(book->getId());
+    size_t lineNumber() const { return number; }
+};
+
+// Поля строки через разделитель; вектор переиспользуется между строками.
+// Как и при разборе через getline, пустое поле в конце строки не считается
+void splitFields(std::string_view line, char delimiter, std::vector<std::string_view>& fields) {
+    fields.clear();
+    while (!line.empty()) {
+        const auto* hit = static_cast<const char*>(std::memchr(line.data(), delimiter, line.size()));
+        if (!hit) {
+            fields.push_back(line);
+            break;
         }
-    } catch (const std::exception& e) {
-        throw FileException("Не удалось загрузить систему библиотеки: " + std::string(e.what()));
+        size_t length = static_cast<size_t>(hit - line.data());
+        fields.push_back(line.substr(0, length));
+        line.remove_prefix(length + 1);
     }
 }
 
-void FileManager::saveBooks(const LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ofstream file(filenameStr);
-    if (!file.is_open()) {
-        throw FileException("Не удалось открыть файл: " + filenameStr);
+void requireFields(const std::vector<std::string_view>& fields, size_t count) {
+    if (fields.size() < count) {
+        throw DataException("ожидалось полей: не менее " + std::to_string(count) + ", найдено " + std::to_string(fields.size()));
     }
-    
-    auto allBooks = system.getAllBooks();
-    for (const auto* book : allBooks) {
-        file << book->getId() << "|"
-             << book->getTitle() << "|"
-             << book->getAuthor() << "|"
-             << book->getIsbn() << "|"
-             << book->getYear() << "|"
-             << book->getGenre() << "|"
-             << (book->isAvailable() ? "1" : "0") << "|"
-             << book->getCoverPath() << "|"
-             << book->getQuantity() << "|"
-             << book->getDescription() << "|"
-             << book->getPdfPath() << "|"
-             << (book->getManuallyDisabled() ? "1" : "0") << "\n";
+}
+
+int parseInt(std::string_view field, const char* name) {
+    int value = 0;
+    const char* last = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), last, value);
+    if (ec != std::errc() || ptr != last) {
+        throw DataException(std::string(name) + ": некорректное число \"" + std::string(field) + "\"");
     }
-    file.close();
+    return value;
+}
+
+double parseDouble(std::string_view field, const char* name) {
+    double value = 0;
+#if defined(__cpp_lib_to_chars)
+    const char* last = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), last, value);
+    bool valid = ec == std::errc() && ptr == last;
+#else
+    // std::from_chars для double есть не везде (libc++ в Apple clang, GCC до 11).
+    // Поток с локалью "C": десятичный разделитель - точка при любой системной локали
+    std::istringstream stream{std::string(field)};
+    stream.imbue(std::locale::classic());
+    bool valid = !field.empty() && (stream >> std::noskipws >> value) && stream.peek() == std::char_traits<char>::eof();
+#endif
+    if (!valid) {
+        throw DataException(std::string(name) + ": некорректное число \"" + std::string(field) + "\"");
+    }
+    return value;
+}
+
+// Поля записей начиная с parts[first]: в файлах данных first = 0,
+// в журнале перед полями стоит тип записи
+struct BookRecord {
+    int id;
+    std::string_view title;
+    std::string_view author;
+    std::string_view isbn;
+    int year;
+    std::string_view genre;
+    bool available;
+    std::string_view coverPath;
+    int quantity;
+    std::string_view description;
+    std::string_view pdfPath;
+    bool manuallyDisabled;
+};
+
+BookRecord parseBook(const std::vector<std::string_view>& parts, size_t first) {
+    requireFields(parts, first + 7);
+    const std::string_view* f = parts.data() + first;
+    size_t count = parts.size() - first;
+    BookRecord record;
+    record.id = parseInt(f[0], "ID");
+    record.title = f[1];
+    record.author = f[2];
+    record.isbn = f[3];
+    record.year = parseInt(f[4], "год");
+    record.genre = f[5];
+    record.available = (f[6] == "1");
+    record.coverPath = (count >= 8) ? f[7] : std::string_view();
+    record.quantity = (count >= 9) ? parseInt(f[8], "количество") : 1;
+    record.description = (count >= 10) ? f[9] : std::string_view();
+    record.pdfPath = (count >= 11) ? f[10] : std::string_view();
+    record.manuallyDisabled = (count >= 12 && f[11] == "1");
+    return record;
+}
+
+struct MemberRecord {
+    int id;
+    std::string_view name;
+    std::string_view surname;
+    std::string_view phone;
+    std::string_view email;
+    bool blocked;
+};
+
+MemberRecord parseMember(const std::vector<std::string_view>& parts, size_t first) {
+    requireFields(parts, first + 5);
+    const std::string_view* f = parts.data() + first;
+    size_t count = parts.size() - first;
+    MemberRecord record;
+    record.id = parseInt(f[0], "ID");
+    record.name = f[1];
+    record.surname = f[2];
+    record.phone = f[3];
+    record.email = (count >= 6) ? f[4] : std::string_view();
+    record.blocked = (count >= 6) ? (f[5] == "1") : (f[4] == "1");
+    return record;
+}
+
+// Поля выдачи после ID абонента: книга, дата выдачи, срок/дата возврата, возвращена, работник
+BorrowedBook parseLoan(const std::vector<std::string_view>& parts, size_t first) {
+    requireFields(parts, first + 4);
+    const std::string_view* f = parts.data() + first;
+    size_t count = parts.size() - first;
+    BorrowedBook loan(parseInt(f[0], "ID книги"), Date::fromString(f[1]), Date::fromString(f[2]),
+                      (count >= 5) ? parseInt(f[4], "ID работника") : 0);
+    loan.returned = (f[3] == "1");
+    return loan;
+}
+
+struct EmployeeRecord {
+    int id;
+    std::string_view name;
+    std::string_view surname;
+    std::string_view phone;
+    bool isLibrarian;
+    double salary;
+    int workHours;
+};
+
+EmployeeRecord parseEmployee(const std::vector<std::string_view>& parts, size_t first) {
+    requireFields(parts, first + 8);
+    const std::string_view* f = parts.data() + first;
+    EmployeeRecord record;
+    record.id = parseInt(f[0], "ID");
+    record.name = f[1];
+    record.surname = f[2];
+    record.phone = f[3];
+    record.isLibrarian = (InternedString(f[4]) == Librarian::positionKey());
+    record.salary = parseDouble(f[5], "зарплата");
+    record.workHours = parseInt(f[6], "часы работы");
+    return record;
+}
+
+// Записи BOOK пакета журнала, начиная с batch[first], меняют ISBN существующих книг одним
+// шагом (LibrarySystem::changeBookIsbns). По одной записи обмен ISBN между книгами внутри
+// пакета не прошёл бы проверку уникальности, и обе правки потерялись бы при восстановлении
+void changeJournalIsbns(LibrarySystem& system, const std::vector<std::pair<size_t, std::string_view>>& batch, size_t first) {
+    std::vector<std::pair<int, std::string_view>> changes;
+    std::vector<std::string_view> fields;
+    for (size_t i = first; i < batch.size(); ++i) {
+        if (batch[i].second.substr(0, 5) != "BOOK|") continue;
+        splitFields(batch[i].second, '|', fields);
+        try {
+            BookRecord r = parseBook(fields, 1);
+            if (const Book* book = system.findBook(r.id); book && book->getIsbn() != r.isbn) {
+                changes.emplace_back(r.id, r.isbn);
+            }
+        } catch (const LibraryException&) {
+            // Ошибка в записи будет описана, когда до неё дойдёт очередь
+        }
+    }
+    system.changeBookIsbns(changes);
 }
 
-void FileManager::loadBooks(LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ifstream file(filenameStr);
-    if (!file.is_open()) {
+// Применение записи журнала. Записи содержат состояние целиком, поэтому
+// повторное применение ничего не меняет
+void applyJournalRecord(LibrarySystem& system, const std::vector<std::string_view>& parts) {
+    std::string_view type = parts[0];
+    if (type == "BOOK") {
+        BookRecord r = parseBook(parts, 1);
+        if (system.findBook(r.id)) {
+            system.editBookDirect(r.id, r.title, r.author, r.isbn, r.year, r.genre, r.coverPath, r.quantity, r.description, r.pdfPath);
+        } else {
+            Book& book = system.addBookWithId(r.id, r.title, r.author, r.isbn, r.year, r.genre, r.available, r.coverPath, r.quantity, r.description, r.pdfPath);
+            // У книги, удалённой и восстановленной отменой, в истории остались невозвращённые экземпляры
+            const LoanStore& loans = system.getLoanStore();
+            int activeLoans = 0;
+            for (LoanStore::LoanId loanId : loans.getBookLoans(r.id)) {
+                activeLoans += loans.get(loanId).returned ? 0 : 1;
+            }
+            book.setActiveLoans(activeLoans);
+        }
+        system.findBook(r.id)->setManuallyDisabled(r.manuallyDisabled);
+        system.updateBookAvailability(r.id);
+    } else if (type == "DELBOOK") {
+        requireFields(parts, 2);
+        if (int id = parseInt(parts[1], "ID"); system.findBook(id)) {
+            system.removeBookDirect(id);
+        }
+    } else if (type == "MEMBER") {
+        MemberRecord r = parseMember(parts, 1);
+        if (system.findMember(r.id)) {
+            system.editMemberDirect(r.id, r.name, r.surname, r.phone, r.email);
+            if (r.blocked) {
+                system.blockMemberDirect(r.id);
+            } else {
+                system.unblockMemberDirect(r.id);
+            }
+        } else {
+            system.addMemberWithId(r.id, r.name, r.surname, r.phone, r.blocked, r.email);
+        }
+    } else if (type == "DELMEMBER") {
+        requireFields(parts, 2);
+        if (int id = parseInt(parts[1], "ID"); system.findMember(id)) {
+            system.removeMemberDirect(id);
+        }
+    } else if (type == "EMPLOYEE") {
+        EmployeeRecord r = parseEmployee(parts, 1);
+        const Employee* existing = system.findEmployee(r.id);
+        if (existing && (existing->getPositionKey() == Librarian::positionKey()) == r.isLibrarian) {
+            system.editEmployeeDirect(r.id, r.name, r.surname, r.phone, r.salary, r.workHours);
+        } else {
+            if (existing) {
+                system.removeEmployeeDirect(r.id); // Должность сменилась - другой класс
+            }
+            system.addEmployeeWithId(r.id, r.name, r.surname, r.phone, r.salary, r.workHours, r.isLibrarian);
+        }
+    } else if (type == "DELEMPLOYEE") {
+        requireFields(parts, 2);
+        if (int id = parseInt(parts[1], "ID"); system.findEmployee(id)) {
+            system.removeEmployeeDirect(id);
+        }
+    } else if (type == "LOAN") {
+        requireFields(parts, 3);
+        int memberId = parseInt(parts[1], "ID абонента");
+        int index = parseInt(parts[2], "номер выдачи");
+        if (index < 0) {
+            throw DataException("номер выдачи: отрицательное число");
+        }
+        system.restoreLoan(memberId, static_cast<size_t>(index), parseLoan(parts, 3));
+    } else if (type == "META") {
+        requireFields(parts, 3);
+        system.setNextBookId(parseInt(parts[1], "nextBookId"));
+        system.setNextEmployeeId(parseInt(parts[2], "nextEmployeeId"));
+    } else {
+        throw DataException("неизвестная запись журнала \"" + std::string(type) + "\"");
+    }
+}
+
+// Сегменты контрольных точек: "<раздел>.<номер контрольной точки>.bin", раздел - "books-3"
+const char* const SEGMENT_DIR = "segments";
+// Данные прежних версий: читаются, пока нет manifest.txt, и убираются после первой контрольной точки
+const char* const TEXT_FILES[] = {"books.txt", "members.txt", "employees.txt", "metadata.txt"};
+
+std::string segmentName(const char* kind, int partition) {
+    return std::string(kind) + "-" + std::to_string(partition);
+}
+
+// Разбор файла записей: handle получает поля каждой непустой строки.
+// Ошибка в строке не прерывает загрузку - строка пропускается и попадает в problems с номером
+template<typename Handler>
+void readRecords(std::string_view filename, char delimiter, std::vector<std::string>& problems, Handler handle) {
+    MappedFile file{std::string(filename)};
+    if (!file.isOpen()) {
         return; // Файл может не существовать при первой загрузке
     }
+    std::string_view shortName = filename.substr(filename.find_last_of("/\\") + 1);
     
-    std::string line;
-    while (std::getline(file, line)) {
+    LineReader reader(file.view());
+    std::vector<std::string_view> fields;
+    std::string_view line;
+    while (reader.next(line)) {
         if (line.empty()) continue;
         
-        auto parts = split(line, '|');
-        if (parts.size() >= 7) {
-            int id = std::stoi(parts[0]);
-            std::string title = parts[1];
-            std::string author = parts[2];
-            std::string isbn = parts[3];
-            int year = std::stoi(parts[4]);
-            std::string genre = parts[5];
-            bool available = (parts[6] == "1");
-            std::string coverPath = (parts.size() >= 8) ? parts[7] : "";
-            int quantity = (parts.size() >= 9) ? std::stoi(parts[8]) : 1;
-            std::string description = (parts.size() >= 10) ? parts[9] : "";
-            std::string pdfPath = (parts.size() >= 11) ? parts[10] : "";
-            bool manuallyDisabled = (parts.size() >= 12 && parts[11] == "1");
-            
-            system.addBookWithId(id, title, author, isbn, year, genre, available, coverPath, quantity, description, pdfPath);
-            // Устанавливаем ручную блокировку после создания книги
-            Book* book = system.findBook(id);
-            if (book) {
-                book->setManuallyDisabled(manuallyDisabled);
-                // Обновляем доступность с учетом ручной блокировки
-                system.updateBookAvailability(id);
-            }
+        splitFields(line, delimiter, fields);
+        try {
+            handle(fields);
+        } catch (const LibraryException& e) {
+            problems.push_back(std::string(shortName) + ", строка " + std::to_string(reader.lineNumber()) + ": " + e.what());
         }
     }
-    file.close();
 }
 
-void FileManager::saveMembers(const LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ofstream file(filenameStr);
-    if (!file.is_open()) {
-        throw FileException("Не удалось открыть файл: " + filenameStr);
+// Сегменты одного вида - по возрастанию номера раздела, чтобы записи загружались в порядке ID
+struct SegmentOrder {
+    bool operator()(const std::string& left, const std::string& right) const {
+        size_t leftDash = left.rfind('-');
+        size_t rightDash = right.rfind('-');
+        int byKind = left.compare(0, leftDash, right, 0, rightDash);
+        if (byKind != 0) {
+            return byKind < 0;
+        }
+        return std::atoi(left.c_str() + leftDash + 1) < std::atoi(right.c_str() + rightDash + 1);
     }
-    
-    auto allMembers = system.getAllMembers();
-    for (const auto* member : allMembers) {
-        file << member->getId() << "|"
-             << member->getName() << "|"
-             << member->getSurname() << "|"
-             << member->getPhone() << "|"
-             << member->getEmail() << "|"
-             << (member->getIsBlocked() ? "1" : "0") << "\n";
-        
-        // Сохраняем взятые книги (включая историю)
-        auto borrowed = member->getBorrowedBooks();
-        for (const auto& book : borrowed) {
-            file << "BORROWED|" << member->getId() << "|"
-                 << book.bookId << "|"
-                 << book.borrowDate << "|"
-                 << book.returnDate << "|"
-                 << (book.returned ? "1" : "0") << "|"
-                 << book.employeeId << "\n";
+};
+
+// Действующая контрольная точка (manifest.txt): номер, счётчики ID и строка
+// "segment=<файл>" на каждый сегмент. Раздел сегмента - имя файла до первой точки
+struct Manifest {
+    int checkpoint = 0;
+    int nextBookId = 1;
+    int nextEmployeeId = 1;
+    std::map<std::string, std::string, SegmentOrder> segments; // Раздел -> файл в SEGMENT_DIR
+};
+
+std::string segmentOf(std::string_view file) {
+    return std::string(file.substr(0, file.find('.')));
+}
+
+Manifest readManifest(const std::string& filename) {
+    Manifest manifest;
+    std::vector<std::string> problems;
+    readRecords(filename, '=', problems, [&manifest](const std::vector<std::string_view>& parts) {
+        requireFields(parts, 2);
+        std::string_view key = parts[0];
+        if (key == "checkpoint") {
+            manifest.checkpoint = parseInt(parts[1], "checkpoint");
+        } else if (key == "nextBookId") {
+            manifest.nextBookId = parseInt(parts[1], "nextBookId");
+        } else if (key == "nextEmployeeId") {
+            manifest.nextEmployeeId = parseInt(parts[1], "nextEmployeeId");
+        } else if (key == "segment") {
+            manifest.segments[segmentOf(parts[1])] = std::string(parts[1]);
         }
+    });
+    // Манифест заменяется целиком, поэтому ошибка в нём - повреждение, а не недописанная строка
+    if (!problems.empty()) {
+        throw DataException(problems.front());
     }
-    file.close();
+    return manifest;
+}
+
+bool hasLegacyData(const std::string& basePath) {
+    return std::any_of(std::begin(TEXT_FILES), std::end(TEXT_FILES), [&basePath](const char* name) {
+        return std::filesystem::exists(basePath + "/" + name);
+    }) || std::filesystem::exists(FileManager::snapshotPath(basePath));
 }
 
-void FileManager::loadMembers(LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ifstream file(filenameStr);
-    if (!file.is_open()) {
+// Уборка: сегменты, которых нет в манифесте, и снимок одним файлом (library.bin). Текстовые
+// файлы прежних версий не удаляются, а один раз переименовываются в *.bak: это копия данных
+// пользователя на случай отката. Ошибки не мешают работе - оставшиеся файлы уберутся
+// при следующей уборке
+void removeStaleFiles(const std::string& basePath, const Manifest& manifest) {
+    std::error_code error;
+    std::vector<std::filesystem::path> stale;
+    for (std::filesystem::directory_iterator it(basePath + "/" + SEGMENT_DIR, error), end; !error && it != end; it.increment(error)) {
+        std::string file = it->path().filename().string();
+        auto segment = manifest.segments.find(segmentOf(file));
+        if (segment == manifest.segments.end() || segment->second != file) {
+            stale.push_back(it->path());
+        }
+    }
+    for (const std::filesystem::path& path : stale) {
+        std::filesystem::remove(path, error);
+    }
+    for (const char* name : TEXT_FILES) {
+        std::string file = basePath + "/" + name;
+        // Существующую копию не заменяем: в ней данные до первого перехода на сегменты
+        if (std::filesystem::exists(file, error) && !std::filesystem::exists(file + ".bak", error)) {
+            std::filesystem::rename(file, file + ".bak", error);
+        }
+    }
+    std::filesystem::remove(FileManager::snapshotPath(basePath), error);
+}
+
+// Обход всех ID раздела по возрастанию. partitionOf округляет к нулю, поэтому в разделе 0
+// лежат и отрицательные ID до -9999. Поиск по ID в контейнерах - прямая адресация (IdIndex),
+// так что обход раздела не зависит от числа записей в остальных разделах
+template <typename Visit>
+void forEachPartitionId(int partition, Visit visit) {
+    constexpr long long size = DirtyPartitions::PARTITION_SIZE;
+    long long first = (partition > 0) ? partition * size : partition * size - (size - 1);
+    long long last = (partition < 0) ? partition * size : partition * size + (size - 1);
+    first = std::max<long long>(first, std::numeric_limits<int>::min());
+    last = std::min<long long>(last, std::numeric_limits<int>::max());
+    for (long long id = first; id <= last; ++id) {
+        visit(static_cast<int>(id));
+    }
+}
+}
+
+void FileManager::saveLibrarySystem(const LibrarySystem& system, std::string_view basePath) {
+    try {
+        std::string basePathStr(basePath);
+        BufferedWriter books(basePathStr + "/books.txt");
+        saveBooks(system, books);
+        books.close();
+        BufferedWriter members(basePathStr + "/members.txt");
+        saveMembers(system, members);
+        members.close();
+        BufferedWriter employees(basePathStr + "/employees.txt");
+        saveEmployees(system, employees);
+        employees.close();
+        BufferedWriter metadata(basePathStr + "/metadata.txt");
+        saveMetadata(system, metadata);
+        metadata.close();
+    } catch (const std::exception& e) {
+        throw FileException("Не удалось сохранить систему библиотеки: " + std::string(e.what()));
+    }
+}
+
+void FileManager::Snapshot::merge(Snapshot newer) {
+    if (newer.full) {
+        *this = std::move(newer);
         return;
     }
+    for (auto& [name, image] : newer.segments) {
+        segments[name] = std::move(image);
+    }
+    nextBookId = newer.nextBookId;
+    nextEmployeeId = newer.nextEmployeeId;
+}
+
+FileManager::Snapshot FileManager::captureSnapshot(const LibrarySystem& system, const DirtyPartitions& dirty) {
+    Snapshot snapshot;
+    snapshot.full = dirty.all;
+    snapshot.nextBookId = system.getNextBookId();
+    snapshot.nextEmployeeId = system.getNextEmployeeId();
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    std::map<int, BinarySnapshot::Contents> books;
+    std::map<int, BinarySnapshot::Contents> members;
+    std::map<int, BinarySnapshot::Contents> employees;
+    if (dirty.all) {
+        // Полная контрольная точка: все записи раскладываются по сегментам за один проход
+        for (const Book& book : system.getBooks()) {
+            books[DirtyPartitions::partitionOf(book.getId())].books.push_back(&book);
+        }
+        for (const LibraryMember& member : system.getMembers()) {
+            members[DirtyPartitions::partitionOf(member.getId())].members.push_back(&member);
+        }
+        for (const Employee& emp : system.getEmployees()) {
+            employees[DirtyPartitions::partitionOf(emp.getId())].employees.push_back(&emp);
+        }
+    } else {
+        // Только изменённые разделы: стоимость зависит от их числа, а не от размера базы.
+        // Контрольная точка снимается в потоке интерфейса
+        for (int partition : dirty.books) {
+            forEachPartitionId(partition, [&](int id) {
+                if (const Book* book = system.findBook(id)) {
+                    books[partition].books.push_back(book);
+                }
+            });
+        }
+        for (int partition : dirty.members) {
+            forEachPartitionId(partition, [&](int id) {
+                if (const LibraryMember* member = system.findMember(id)) {
+                    members[partition].members.push_back(member);
+                }
+            });
+        }
+        for (int partition : dirty.employees) {
+            forEachPartitionId(partition, [&](int id) {
+                if (const Employee* emp = system.findEmployee(id)) {
+                    employees[partition].employees.push_back(emp);
+                }
+            });
+        }
+    }
+    
+    // Изменённый раздел без записей остаётся с пустым образом - его сегмент удаляется
+    auto addSegments = [&snapshot, &system](const char* kind, const std::set<int>& partitions,
+                                            const std::map<int, BinarySnapshot::Contents>& contents) {
+        for (int partition : partitions) {
+            snapshot.segments[segmentName(kind, partition)];
+        }
+        for (const auto& [partition, records] : contents) {
+            snapshot.segments[segmentName(kind, partition)] = BinarySnapshot::capture(system, records);
+        }
+    };
+    addSegments("books", dirty.books, books);
+    addSegments("members", dirty.members, members);
+    addSegments("employees", dirty.employees, employees);
+    return snapshot;
+}
+
+void FileManager::writeFile(const std::string& path, std::string_view header, std::string_view body) {
+    BufferedWriter file(path);
+    file << header << body;
+    file.close();
+    Journal::syncFile(path);
+}
+
+void FileManager::writeSnapshot(const Snapshot& snapshot, std::string_view basePath, int checkpoint) {
+    std::string basePathStr(basePath);
+    std::string manifestFile = manifestPath(basePath);
+    Manifest manifest;
+    try {
+        if (std::filesystem::exists(manifestFile)) {
+            manifest = readManifest(manifestFile);
+        } else if (!snapshot.full && hasLegacyData(basePathStr)) {
+            throw DataException("данные ещё не разбиты на сегменты - нужна полная контрольная точка");
+        }
+        if (snapshot.full) {
+            manifest.segments.clear();
+        }
         
-        // Пропускаем строки с взятыми книгами - они загружаются отдельно
-        if (line.find("BORROWED|") == 0) {
-            continue;
+        // Номер контрольной точки в имени: действующие сегменты не перезаписываются
+        std::string segmentDir = basePathStr + "/" + SEGMENT_DIR;
+        std::filesystem::create_directories(segmentDir);
+        for (const auto& [name, image] : snapshot.segments) {
+            if (image.empty()) {
+                manifest.segments.erase(name);
+                continue;
+            }
+            std::string file = name + "." + std::to_string(checkpoint) + ".bin";
+            std::string header = image.substr(0, BinarySnapshot::HEADER_SIZE);
+            BinarySnapshot::setCheckpoint(header, checkpoint);
+            writeFile(segmentDir + "/" + file, header, std::string_view(image).substr(header.size()));
+            manifest.segments[name] = file;
         }
+        Journal::syncDirectory(segmentDir);
         
-        auto parts = split(line, '|');
-        if (parts.size() >= 5) {
-            int id = std::stoi(parts[0]);
-            std::string name = parts[1];
-            std::string surname = parts[2];
-            std::string phone = parts[3];
-            std::string email = (parts.size() >= 6) ? parts[4] : "";
-            bool blocked = (parts.size() >= 6) ? (parts[5] == "1") : (parts[4] == "1");
-            
-            system.addMemberWithId(id, name, surname, phone, blocked, email);
+        manifest.checkpoint = checkpoint;
+        manifest.nextBookId = snapshot.nextBookId;
+        manifest.nextEmployeeId = snapshot.nextEmployeeId;
+        std::string text;
+        BufferedWriter out(&text);
+        out << "checkpoint=" << manifest.checkpoint << '\n'
+            << "nextBookId=" << manifest.nextBookId << '\n'
+            << "nextEmployeeId=" << manifest.nextEmployeeId << '\n';
+        for (const auto& [name, file] : manifest.segments) {
+            out << "segment=" << file << '\n';
         }
+        out.close();
+        // Переименование - единственный шаг, после которого действует новый набор сегментов
+        writeFile(manifestFile + ".new", text, {});
+        std::filesystem::rename(manifestFile + ".new", manifestFile);
+    } catch (const std::exception& e) {
+        throw FileException("Не удалось сохранить систему библиотеки: " + std::string(e.what()));
     }
-    file.close();
+    
+    try {
+        Journal::syncDirectory(basePathStr);
+    } catch (const FileException&) {
+        // Манифест уже заменён; каталог сбросит на диск следующая контрольная точка
+    }
+    removeStaleFiles(basePathStr, manifest);
 }
 
-void FileManager::loadBorrowedBooks(LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ifstream file(filenameStr);
-    if (!file.is_open()) {
-        return;
+void FileManager::recoverSnapshot(const std::string& basePath) {
+    std::string manifestFile = manifestPath(basePath);
+    std::filesystem::remove(manifestFile + ".new");
+    if (std::filesystem::exists(manifestFile)) {
+        removeStaleFiles(basePath, readManifest(manifestFile)); // Сегменты прерванной контрольной точки
+    }
+}
+
+std::string FileManager::journalPath(std::string_view basePath) {
+    return std::string(basePath) + "/journal.log";
+}
+
+std::string FileManager::snapshotPath(std::string_view basePath) {
+    return std::string(basePath) + "/library.bin";
+}
+
+std::string FileManager::manifestPath(std::string_view basePath) {
+    return std::string(basePath) + "/manifest.txt";
+}
+
+int FileManager::readCheckpoint(std::string_view basePath) {
+    if (std::string manifestFile = manifestPath(basePath); std::filesystem::exists(manifestFile)) {
+        return readManifest(manifestFile).checkpoint;
+    }
+    if (BinarySnapshot snapshot(snapshotPath(basePath)); snapshot.isOpen()) {
+        return snapshot.getCheckpoint();
     }
+    // Данные ещё в текстовых файлах: номер мог остаться в metadata.txt
+    int checkpoint = 0;
+    std::vector<std::string> problems;
+    readRecords(std::string(basePath) + "/metadata.txt", '=', problems, [&checkpoint](const std::vector<std::string_view>& parts) {
+        if (parts.size() >= 2 && parts[0] == "checkpoint") {
+            checkpoint = parseInt(parts[1], "значение");
+        }
+    });
+    return checkpoint;
+}
+
+std::string FileManager::captureJournalBatch(const LibrarySystem& system, const ChangeTracker& changes) {
+    std::string batch;
+    BufferedWriter file(&batch);
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        if (line.find("BORROWED|") == 0) {
-            // Загрузка информации о взятых книгах (включая историю)
-            auto parts = split(line, '|');
-            if (parts.size() >= 6) {
-                int memberId = std::stoi(parts[1]);
-                int bookId = std::stoi(parts[2]);
-                std::string borrowDate = parts[3];
-                std::string returnDate = parts[4];
-                bool returned = (parts[5] == "1");
-                int employeeId = (parts.size() >= 7) ? std::stoi(parts[6]) : 0;
-                
-                try {
-                    system.addBorrowedBook(memberId, bookId, borrowDate, returnDate, returned, employeeId);
-                } catch (const LibraryException& e) {
-                    // Игнорируем ошибки при загрузке взятых книг
-                    (void)e; // Suppress unused variable warning
-                }
+    // Сначала удаления: запись, удалённая и восстановленная отменой, пересоздаётся
+    // ниже заново, без истории, которая была у неё до удаления
+    for (int id : changes.removedBooks) {
+        file << "DELBOOK|" << id << '\n';
+    }
+    for (int id : changes.removedMembers) {
+        file << "DELMEMBER|" << id << '\n';
+    }
+    for (int id : changes.removedEmployees) {
+        file << "DELEMPLOYEE|" << id << '\n';
+    }
+    
+    // Удалённые и восстановленные записи, которые потом не менялись, тоже выписываются целиком
+    auto changedOrRemoved = [](const std::unordered_set<int>& changed, const std::unordered_set<int>& removed) {
+        std::vector<int> ids(changed.begin(), changed.end());
+        for (int id : removed) {
+            if (!changed.count(id)) {
+                ids.push_back(id);
             }
         }
+        return ids;
+    };
+    for (int id : changedOrRemoved(changes.changedBooks, changes.removedBooks)) {
+        if (const Book* book = system.findBook(id)) {
+            file << "BOOK|";
+            writeBook(file, *book);
+        }
     }
+    for (int id : changedOrRemoved(changes.changedMembers, changes.removedMembers)) {
+        if (const LibraryMember* member = system.findMember(id)) {
+            file << "MEMBER|";
+            writeMember(file, *member);
+        }
+    }
+    for (int id : changedOrRemoved(changes.changedEmployees, changes.removedEmployees)) {
+        if (const Employee* emp = system.findEmployee(id)) {
+            file << "EMPLOYEE|";
+            writeEmployee(file, *emp);
+        }
+    }
+    
+    // Выдачи - по возрастанию номера, то есть в порядке выдачи внутри истории абонента.
+    // Выдача адресуется номером в истории: номера LoanStore после загрузки другие
+    std::vector<LoanStore::LoanId> loanIds = changes.changedLoans;
+    std::sort(loanIds.begin(), loanIds.end());
+    loanIds.erase(std::unique(loanIds.begin(), loanIds.end()), loanIds.end());
+    const LoanStore& loans = system.getLoanStore();
+    for (LoanStore::LoanId loanId : loanIds) {
+        const BorrowedBook& loan = loans.get(loanId);
+        const std::vector<LoanStore::LoanId>& history = loans.getMemberLoans(loan.memberId);
+        auto it = std::find(history.begin(), history.end(), loanId);
+        if (it == history.end()) {
+            continue; // Абонент удалён вместе с историей
+        }
+        file << "LOAN|" << loan.memberId << '|' << static_cast<int>(it - history.begin()) << '|';
+        writeLoan(file, loan);
+    }
+    
+    file << "META|" << system.getNextBookId() << '|' << system.getNextEmployeeId() << '\n';
+    file << Journal::COMMIT << '\n';
     file.close();
+    return batch;
 }
 
-void FileManager::saveEmployees(const LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ofstream file(filenameStr);
-    if (!file.is_open()) {
-        throw FileException("Не удалось открыть файл: " + filenameStr);
+void FileManager::replayJournal(LibrarySystem& system, std::string_view filename, int checkpoint, std::vector<std::string>& problems) {
+    MappedFile file{std::string(filename)};
+    if (!file.isOpen()) {
+        return;
     }
+    // Журнал другой контрольной точки устарел; недописанный пакет в конце пропускается
+    std::string_view text = file.view().substr(0, Journal::committedLength(file.view(), checkpoint));
+    std::string_view shortName = filename.substr(filename.find_last_of("/\\") + 1);
     
-    auto allEmployees = system.getAllEmployees();
-    for (const auto* emp : allEmployees) {
-        file << emp->getId() << "|"
-             << emp->getName() << "|"
-             << emp->getSurname() << "|"
-             << emp->getPhone() << "|"
-             << emp->getPosition() << "|"
-             << emp->getSalary() << "|"
-             << emp->getWorkHours() << "|";
-        
-        if (emp->getType() == "Librarian") {
-            const auto* lib = dynamic_cast<const Librarian*>(emp);
-            if (lib) {
-                file << lib->getBooksProcessed() << "\n";
+    LineReader reader(text);
+    std::vector<std::pair<size_t, std::string_view>> batch; // Номер строки и строка
+    std::vector<std::string_view> fields;
+    auto applyBatch = [&]() {
+        bool isbnsChanged = false;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // Удаления идут в пакете первыми; ISBN книг меняются разом перед первой записью BOOK
+            if (!isbnsChanged && batch[i].second.substr(0, 5) == "BOOK|") {
+                changeJournalIsbns(system, batch, i);
+                isbnsChanged = true;
             }
-        } else if (emp->getType() == "Manager") {
-            const auto* mgr = dynamic_cast<const Manager*>(emp);
-            if (mgr) {
-                file << mgr->getEmployeesManaged() << "\n";
+            splitFields(batch[i].second, '|', fields);
+            try {
+                applyJournalRecord(system, fields);
+            } catch (const LibraryException& e) {
+                problems.push_back(std::string(shortName) + ", строка " + std::to_string(batch[i].first) + ": " + e.what());
             }
         }
+        batch.clear();
+    };
+    std::string_view line;
+    reader.next(line); // Заголовок
+    while (reader.next(line)) {
+        if (line == Journal::COMMIT) {
+            applyBatch();
+        } else if (!line.empty()) {
+            batch.emplace_back(reader.lineNumber(), line);
+        }
     }
-    file.close();
+    applyBatch();
 }
 
-void FileManager::loadEmployees(LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ifstream file(filenameStr);
-    if (!file.is_open()) {
-        return;
+std::vector<std::string> FileManager::loadLibrarySystem(LibrarySystem& system, std::string_view basePath) {
+    // Записи контрольной точки уже на диске - о них слушателю знать незачем
+    ChangeListener* listener = system.getChangeListener();
+    system.setChangeListener(nullptr);
+    try {
+        std::string basePathStr(basePath);
+        recoverSnapshot(basePathStr);
+        
+        std::vector<std::string> problems; // Записи, которые не удалось разобрать
+        std::string snapshotFile = snapshotPath(basePath);
+        int checkpoint = 0;
+        if (std::filesystem::exists(manifestPath(basePath))) {
+            checkpoint = loadSegments(system, basePathStr, problems);
+        } else if (std::filesystem::exists(snapshotFile)) {
+            checkpoint = loadBinary(system, snapshotFile, problems);
+        } else {
+            checkpoint = loadText(system, basePathStr, problems);
+        }
+        
+        // Изменения после контрольной точки - поверх загруженного снимка. Слушатель получает их:
+        // в сегментах их ещё нет, и следующая контрольная точка должна переписать эти разделы
+        system.setChangeListener(listener);
+        replayJournal(system, journalPath(basePath), checkpoint, problems);
+        return problems;
+    } catch (const std::exception& e) {
+        system.setChangeListener(listener);
+        throw FileException("Не удалось загрузить систему библиотеки: " + std::string(e.what()));
     }
+}
+
+std::vector<std::string> FileManager::importLibrarySystem(LibrarySystem& system, std::string_view basePath) {
+    try {
+        // Счётчики ID из metadata.txt не должны опуститься ниже уже выданных номеров
+        int nextBookId = system.getNextBookId();
+        int nextEmployeeId = system.getNextEmployeeId();
+        std::vector<std::string> problems;
+        loadText(system, std::string(basePath), problems);
+        system.setNextBookId(std::max(nextBookId, system.getNextBookId()));
+        system.setNextEmployeeId(std::max(nextEmployeeId, system.getNextEmployeeId()));
+        return problems;
+    } catch (const std::exception& e) {
+        throw FileException("Не удалось импортировать данные: " + std::string(e.what()));
+    }
+}
+
+int FileManager::loadText(LibrarySystem& system, const std::string& basePath, std::vector<std::string>& problems) {
+    // Записи только накапливаются, индексы и проверки - один раз в endBulkLoad
+    system.beginBulkLoad();
+    try {
+        // Сначала загружаем метаданные (ID счетчики)
+        int checkpoint = loadMetadata(system, basePath + "/metadata.txt", problems);
+        // Затем загружаем книги
+        loadBooks(system, basePath + "/books.txt", problems);
+        // Затем загружаем абонентов вместе со взятыми книгами - за один проход по файлу
+        loadMembers(system, basePath + "/members.txt", problems);
+        // Затем загружаем работников
+        loadEmployees(system, basePath + "/employees.txt", problems);
+        
+        // Индексы, проверка дубликатов и ссылок, доступность всех книг
+        std::vector<std::string> skipped = system.endBulkLoad();
+        problems.insert(problems.end(), skipped.begin(), skipped.end());
+        return checkpoint;
+    } catch (...) {
+        // Уже прочитанные записи остаются в согласованном состоянии
+        system.endBulkLoad();
+        throw;
+    }
+}
+
+int FileManager::loadBinary(LibrarySystem& system, const std::string& snapshotFile, std::vector<std::string>& problems) {
+    BinarySnapshot snapshot(snapshotFile);
+    if (!snapshot.isOpen()) {
+        throw FileException("Не удалось открыть файл: " + snapshotFile);
+    }
+    snapshot.verify();
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    // Число записей известно из заголовков разделов - память выделяется один раз
+    system.beginBulkLoad(snapshot.table(BinarySnapshot::Section::Books).size(),
+                         snapshot.table(BinarySnapshot::Section::Members).size(),
+                         snapshot.table(BinarySnapshot::Section::Loans).size());
+    try {
+        system.setNextBookId(snapshot.getNextBookId());
+        system.setNextEmployeeId(snapshot.getNextEmployeeId());
+        loadRecords(system, snapshot);
         
-        auto parts = split(line, '|');
-        if (parts.size() >= 8) {
-            int id = std::stoi(parts[0]);
-            std::string name = parts[1];
-            std::string surname = parts[2];
-            std::string phone = parts[3];
-            std::string position = parts[4];
-            double salary = std::stod(parts[5]);
-            int workHours = std::stoi(parts[6]);
-            
-            bool isLibrarian = (position == "Librarian");
-            system.addEmployeeWithId(id, name, surname, phone, salary, workHours, isLibrarian);
-        }
+        std::vector<std::string> skipped = system.endBulkLoad();
+        problems.insert(problems.end(), skipped.begin(), skipped.end());
+        return snapshot.getCheckpoint();
+    } catch (...) {
+        system.endBulkLoad();
+        throw;
     }
-    file.close();
 }
 
-void FileManager::saveMetadata(const LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ofstream file(filenameStr);
-    if (!file.is_open()) {
-        throw FileException("Не удалось открыть файл: " + filenameStr);
+int FileManager::loadSegments(LibrarySystem& system, const std::string& basePath, std::vector<std::string>& problems) {
+    Manifest manifest = readManifest(manifestPath(basePath));
+    
+    // Сегменты проверяются до загрузки: из их заголовков известно точное число записей
+    std::deque<BinarySnapshot> segments;
+    size_t bookCount = 0;
+    size_t memberCount = 0;
+    size_t loanCount = 0;
+    for (const auto& [name, file] : manifest.segments) {
+        const BinarySnapshot& segment = segments.emplace_back(basePath + "/" + SEGMENT_DIR + "/" + file);
+        if (!segment.isOpen()) {
+            throw FileException("Нет сегмента " + file + " из manifest.txt");
+        }
+        segment.verify();
+        bookCount += segment.table(BinarySnapshot::Section::Books).size();
+        memberCount += segment.table(BinarySnapshot::Section::Members).size();
+        loanCount += segment.table(BinarySnapshot::Section::Loans).size();
     }
     
-    file << "nextBookId=" << system.getNextBookId() << "\n";
-    file << "nextEmployeeId=" << system.getNextEmployeeId() << "\n";
-    file.close();
+    system.beginBulkLoad(bookCount, memberCount, loanCount);
+    try {
+        system.setNextBookId(manifest.nextBookId);
+        system.setNextEmployeeId(manifest.nextEmployeeId);
+        for (const BinarySnapshot& segment : segments) {
+            loadRecords(system, segment);
+        }
+        
+        std::vector<std::string> skipped = system.endBulkLoad();
+        problems.insert(problems.end(), skipped.begin(), skipped.end());
+        return manifest.checkpoint;
+    } catch (...) {
+        system.endBulkLoad();
+        throw;
+    }
 }
 
-void FileManager::loadMetadata(LibrarySystem& system, std::string_view filename) {
-    std::string filenameStr(filename);
-    std::ifstream file(filenameStr);
-    if (!file.is_open()) {
-        return;
+void FileManager::loadRecords(LibrarySystem& system, const BinarySnapshot& snapshot) {
+    using S = BinarySnapshot;
+    S::Table books = snapshot.table(S::Section::Books);
+    S::Table members = snapshot.table(S::Section::Members);
+    S::Table loans = snapshot.table(S::Section::Loans);
+    S::Table employees = snapshot.table(S::Section::Employees);
+    
+    for (size_t row = 0; row < books.size(); ++row) {
+        Book& book = system.addBookWithId(books.getInt(S::BOOK_ID, row), books.getText(S::BOOK_TITLE, row),
+                                          books.getText(S::BOOK_AUTHOR, row), books.getText(S::BOOK_ISBN, row),
+                                          books.getInt(S::BOOK_YEAR, row), books.getText(S::BOOK_GENRE, row),
+                                          books.getInt(S::BOOK_AVAILABLE, row) != 0, books.getText(S::BOOK_COVER, row),
+                                          books.getInt(S::BOOK_QUANTITY, row), books.getText(S::BOOK_DESCRIPTION, row),
+                                          books.getText(S::BOOK_PDF, row));
+        book.setManuallyDisabled(books.getInt(S::BOOK_DISABLED, row) != 0);
+    }
+    for (size_t row = 0; row < members.size(); ++row) {
+        system.addMemberWithId(members.getInt(S::MEMBER_ID, row), members.getText(S::MEMBER_NAME, row),
+                               members.getText(S::MEMBER_SURNAME, row), members.getText(S::MEMBER_PHONE, row),
+                               members.getInt(S::MEMBER_BLOCKED, row) != 0, members.getText(S::MEMBER_EMAIL, row));
     }
+    for (size_t row = 0; row < loans.size(); ++row) {
+        system.addBorrowedBook(loans.getInt(S::LOAN_MEMBER, row), loans.getInt(S::LOAN_BOOK, row),
+                               Date::fromDays(loans.getInt(S::LOAN_BORROWED, row)), Date::fromDays(loans.getInt(S::LOAN_DUE, row)),
+                               loans.getInt(S::LOAN_RETURNED, row) != 0, loans.getInt(S::LOAN_EMPLOYEE, row));
+    }
+    for (size_t row = 0; row < employees.size(); ++row) {
+        system.addEmployeeWithId(employees.getInt(S::EMPLOYEE_ID, row), employees.getText(S::EMPLOYEE_NAME, row),
+                                 employees.getText(S::EMPLOYEE_SURNAME, row), employees.getText(S::EMPLOYEE_PHONE, row),
+                                 employees.getDouble(S::EMPLOYEE_SALARY, row), employees.getInt(S::EMPLOYEE_HOURS, row),
+                                 employees.getInt(S::EMPLOYEE_LIBRARIAN, row) != 0);
+    }
+}
+
+std::vector<std::string> FileManager::convertTextToBinary(std::string_view textPath, std::string_view binaryFile) {
+    LibrarySystem system;
+    std::vector<std::string> problems = importLibrarySystem(system, textPath);
+    try {
+        std::string image = BinarySnapshot::capture(system);
+        writeFile(std::string(binaryFile), image, {});
+    } catch (const std::exception& e) {
+        throw FileException("Не удалось записать снимок: " + std::string(e.what()));
+    }
+    return problems;
+}
+
+std::vector<std::string> FileManager::convertBinaryToText(std::string_view binaryFile, std::string_view textPath) {
+    LibrarySystem system;
+    std::vector<std::string> problems;
+    try {
+        loadBinary(system, std::string(binaryFile), problems);
+    } catch (const std::exception& e) {
+        throw FileException("Не удалось прочитать снимок: " + std::string(e.what()));
+    }
+    std::error_code error;
+    std::filesystem::create_directories(textPath, error); // Если не вышло - ошибку сообщит запись файлов
+    saveLibrarySystem(system, textPath);
+    return problems;
+}
+
+void FileManager::saveBooks(const LibrarySystem& system, BufferedWriter& file) {
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    for (const Book& book : system.getBooks()) {
+        writeBook(file, book);
+    }
+}
+
+void FileManager::writeBook(BufferedWriter& file, const Book& book) {
+    file << book.getId() << '|'
+         << book.getTitle() << '|'
+         << book.getAuthor() << '|'
+         << book.getIsbn() << '|'
+         << book.getYear() << '|'
+         << book.getGenre() << '|'
+         << (book.isAvailable() ? '1' : '0') << '|'
+         << book.getCoverPath() << '|'
+         << book.getQuantity() << '|'
+         << book.getDescription() << '|'
+         << book.getPdfPath() << '|'
+         << (book.getManuallyDisabled() ? '1' : '0') << '\n';
+}
+
+void FileManager::loadBooks(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems) {
+    readRecords(filename, '|', problems, [&system](const std::vector<std::string_view>& parts) {
+        BookRecord r = parseBook(parts, 0);
+        Book& book = system.addBookWithId(r.id, r.title, r.author, r.isbn, r.year, r.genre, r.available, r.coverPath, r.quantity, r.description, r.pdfPath);
+        // Доступность с учетом ручной блокировки пересчитывается после загрузки выдач
+        book.setManuallyDisabled(r.manuallyDisabled);
+    });
+}
+
+void FileManager::saveMembers(const LibrarySystem& system, BufferedWriter& file) {
+    
+    const LoanStore& loans = system.getLoanStore();
+    for (const LibraryMember& member : system.getMembers()) {
+        writeMember(file, member);
         
-        size_t pos = line.find('=');
-        if (pos != std::string::npos) {
-            std::string key = line.substr(0, pos);
-            int value = std::stoi(line.substr(pos + 1));
+        // Сохраняем взятые книги (включая историю)
+        for (LoanStore::LoanId loanId : loans.getMemberLoans(member.getId())) {
+            file << "BORROWED|" << member.getId() << '|';
+            writeLoan(file, loans.get(loanId));
+        }
+    }
+}
+
+void FileManager::writeMember(BufferedWriter& file, const LibraryMember& member) {
+    file << member.getId() << '|'
+         << member.getName() << '|'
+         << member.getSurname() << '|'
+         << member.getPhone() << '|'
+         << member.getEmail() << '|'
+         << (member.getIsBlocked() ? '1' : '0') << '\n';
+}
+
+void FileManager::writeLoan(BufferedWriter& file, const BorrowedBook& loan) {
+    file << loan.bookId << '|'
+         << loan.borrowDate << '|'
+         << loan.returnDate << '|'
+         << (loan.returned ? '1' : '0') << '|'
+         << loan.employeeId << '\n';
+}
+
+void FileManager::loadMembers(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems) {
+    readRecords(filename, '|', problems, [&system](const std::vector<std::string_view>& parts) {
+        if (parts[0] == "BORROWED") {
+            // Взятые книги (включая историю) могут стоять раньше абонента и книги, на которых ссылаются:
+            // при массовой загрузке выдачи копятся и проверяются в endBulkLoad
+            requireFields(parts, 6);
+            int memberId = parseInt(parts[1], "ID абонента");
+            BorrowedBook loan = parseLoan(parts, 2);
             
-            if (key == "nextBookId") {
-                system.setNextBookId(value);
-            } else if (key == "nextEmployeeId") {
-                system.setNextEmployeeId(value);
-            }
+            system.addBorrowedBook(memberId, loan.bookId, loan.borrowDate, loan.returnDate, loan.returned, loan.employeeId);
+            return;
         }
+        
+        MemberRecord r = parseMember(parts, 0);
+        system.addMemberWithId(r.id, r.name, r.surname, r.phone, r.blocked, r.email);
+    });
+}
+
+void FileManager::saveEmployees(const LibrarySystem& system, BufferedWriter& file) {
+    
+    for (const Employee& emp : system.getEmployees()) {
+        writeEmployee(file, emp);
     }
-    file.close();
 }
 
-std::vector<std::string> FileManager::split(std::string_view str, char delimiter) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::string strStr(str);
-    std::istringstream tokenStream(strStr);
-    while (std::getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
+void FileManager::writeEmployee(BufferedWriter& file, const Employee& emp) {
+    file << emp.getId() << '|'
+         << emp.getName() << '|'
+         << emp.getSurname() << '|'
+         << emp.getPhone() << '|'
+         << emp.getPosition() << '|'
+         << emp.getSalary() << '|'
+         << emp.getWorkHours() << '|';
+    
+    if (emp.getPositionKey() == Librarian::positionKey()) {
+        const auto* lib = dynamic_cast<const Librarian*>(&emp);
+        if (lib) {
+            file << lib->getBooksProcessed() << '\n';
+        }
+    } else if (emp.getPositionKey() == Manager::positionKey()) {
+        const auto* mgr = dynamic_cast<const Manager*>(&emp);
+        if (mgr) {
+            file << mgr->getEmployeesManaged() << '\n';
+        }
     }
-    return tokens;
 }
 
+void FileManager::loadEmployees(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems) {
+    readRecords(filename, '|', problems, [&system](const std::vector<std::string_view>& parts) {
+        EmployeeRecord r = parseEmployee(parts, 0);
+        system.addEmployeeWithId(r.id, r.name, r.surname, r.phone, r.salary, r.workHours, r.isLibrarian);
+    });
+}
+
+void FileManager::saveMetadata(const LibrarySystem& system, BufferedWriter& file) {
+    
+    file << "nextBookId=" << system.getNextBookId() << '\n';
+    file << "nextEmployeeId=" << system.getNextEmployeeId() << '\n';
+}
+
+int FileManager::loadMetadata(LibrarySystem& system, std::string_view filename, std::vector<std::string>& problems) {
+    int checkpoint = 0;
+    readRecords(filename, '=', problems, [&system, &checkpoint](const std::vector<std::string_view>& parts) {
+        if (parts.size() < 2) {
+            return;
+        }
+        std::string_view key = parts[0];
+        int value = parseInt(parts[1], "значение");
+        
+        if (key == "nextBookId") {
+            system.setNextBookId(value);
+        } else if (key == "nextEmployeeId") {
+            system.setNextEmployeeId(value);
+        } else if (key == "checkpoint") {
+            checkpoint = value;
+        }
+    });
+    return checkpoint;
+}
@@ -0,0 +1,60 @@
+#include "idindex.h"
+
+namespace {
+// Таблица прямой адресации растёт без ограничений до этого ID
+constexpr size_t DIRECT_FREE_LIMIT = size_t(1) << 20;
+// Выше лимита ID допускается только при плотности не хуже 1/8
+constexpr size_t DIRECT_SPARSITY = 8;
+}
+
+bool IdIndex::fitsDirect(int id) const {
+    if (id < 0) {
+        return false;
+    }
+    auto uid = static_cast<size_t>(id);
+    return uid < direct.size() || uid < DIRECT_FREE_LIMIT || uid <= DIRECT_SPARSITY * (count + 1);
+}
+
+void IdIndex::insert(int id, size_t pos) {
+    if (id >= 0 && static_cast<size_t>(id) < direct.size() && direct[id] != EMPTY) {
+        direct[id] = static_cast<std::uint32_t>(pos);
+        return;
+    }
+    if (auto it = overflow.find(id); it != overflow.end()) {
+        it->second = pos;
+        return;
+    }
+
+    if (fitsDirect(id)) {
+        if (static_cast<size_t>(id) >= direct.size()) {
+            direct.resize(static_cast<size_t>(id) + 1, EMPTY);
+        }
+        direct[id] = static_cast<std::uint32_t>(pos);
+    } else {
+        overflow.emplace(id, pos);
+    }
+    ++count;
+}
+
+void IdIndex::erase(int id) {
+    if (id >= 0 && static_cast<size_t>(id) < direct.size() && direct[id] != EMPTY) {
+        direct[id] = EMPTY;
+        --count;
+        return;
+    }
+    if (overflow.erase(id) > 0) {
+        --count;
+    }
+}
+
+void IdIndex::clear() {
+    direct.clear();
+    overflow.clear();
+    count = 0;
+}
+
+void IdIndex::reserve(int maxId) {
+    if (fitsDirect(maxId)) {
+        direct.reserve(static_cast<size_t>(maxId) + 1);
+    }
+}
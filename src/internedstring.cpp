@@ -0,0 +1,46 @@
+#include "internedstring.h"
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+
+namespace {
+struct Pool {
+    std::deque<std::string> strings; // deque не перемещает элементы при добавлении
+    std::unordered_map<std::string_view, InternedString::Id> ids; // Ключи ссылаются на strings
+    std::mutex mutex;
+
+    Pool() {
+        strings.emplace_back();
+        ids.emplace(strings.back(), 0);
+    }
+};
+
+// Пул создаётся при первом обращении, поэтому строки можно интернировать и из статических объектов
+Pool& pool() {
+    static Pool instance;
+    return instance;
+}
+}
+
+InternedString::InternedString() : id(0) {
+    static const std::string* emptyString = &pool().strings.front();
+    value = emptyString;
+}
+
+InternedString::InternedString(std::string_view text) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    auto it = p.ids.find(text);
+    if (it == p.ids.end()) {
+        p.strings.emplace_back(text);
+        it = p.ids.emplace(p.strings.back(), static_cast<Id>(p.strings.size() - 1)).first;
+    }
+    id = it->second;
+    value = &p.strings[id];
+}
+
+size_t InternedString::poolSize() {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    return p.strings.size();
+}
@@ -0,0 +1,225 @@
+#include "journal.h"
+#include "exceptions.h"
+#include "mappedfile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+Journal::Journal(std::string_view pPath) : path(pPath) {}
+
+Journal::~Journal() {
+    closeFile();
+}
+
+std::string Journal::header(int generation) {
+    return "JOURNAL|" + std::to_string(generation) + "\n";
+}
+
+size_t Journal::committedLength(std::string_view text, int generation) {
+    std::string expected = header(generation);
+    if (text.substr(0, expected.size()) != expected) {
+        return 0;
+    }
+    size_t committed = expected.size();
+    size_t position = committed;
+    while (position < text.size()) {
+        const auto* newline = static_cast<const char*>(std::memchr(text.data() + position, '\n', text.size() - position));
+        if (!newline) {
+            break; // Строка без перевода строки - запись прервана
+        }
+        size_t end = static_cast<size_t>(newline - text.data());
+        if (text.substr(position, end - position) == COMMIT) {
+            committed = end + 1;
+        }
+        position = end + 1;
+    }
+    return committed;
+}
+
+void Journal::open(int pGeneration) {
+    closeFile();
+    size_t committed = 0;
+    bool exists = false;
+    {
+        MappedFile file(path);
+        if (file.isOpen()) {
+            exists = true;
+            committed = committedLength(file.view(), pGeneration);
+        }
+    } // Отображение снимается до изменения размера файла
+
+    if (committed == 0) {
+        openFile(true);
+        generation = pGeneration;
+        length = 0;
+        try {
+            write(header(pGeneration));
+        } catch (...) {
+            closeFile();
+            throw;
+        }
+        return;
+    }
+
+    std::error_code error;
+    if (exists && std::filesystem::file_size(path, error) > committed) {
+        std::filesystem::resize_file(path, committed, error);
+        if (error) {
+            throw FileException("Не удалось отрезать недописанный хвост журнала " + path + ": " + error.message());
+        }
+    }
+    openFile(false);
+    generation = pGeneration;
+    length = committed;
+}
+
+void Journal::reset(int pGeneration) {
+    closeFile();
+    openFile(true);
+    generation = pGeneration;
+    length = 0;
+    try {
+        write(header(pGeneration));
+    } catch (...) {
+        closeFile();
+        throw;
+    }
+}
+
+void Journal::append(std::string_view batch) {
+    if (!isOpen()) {
+        throw FileException("Журнал не открыт: " + path);
+    }
+    try {
+        write(batch);
+    } catch (...) {
+        // В файле может остаться часть пакета: следующий open отрежет её по последнему COMMIT
+        closeFile();
+        throw;
+    }
+}
+
+#ifdef _WIN32
+void Journal::openFile(bool truncate) {
+    // FlushFileBuffers требует GENERIC_WRITE, поэтому конец файла выставляется вручную
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw FileException("Не удалось открыть журнал: " + path);
+    }
+    LARGE_INTEGER zero{};
+    if (!SetFilePointerEx(file, zero, nullptr, FILE_END)) {
+        CloseHandle(file);
+        throw FileException("Не удалось открыть журнал: " + path);
+    }
+    handle = file;
+}
+
+void Journal::closeFile() {
+    if (handle) {
+        CloseHandle(static_cast<HANDLE>(handle));
+        handle = nullptr;
+    }
+    generation = -1;
+}
+
+void Journal::write(std::string_view data) {
+    auto file = static_cast<HANDLE>(handle);
+    while (!data.empty()) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size(), 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(file, data.data(), chunk, &written, nullptr)) {
+            throw FileException("Ошибка записи в журнал: " + path);
+        }
+        data.remove_prefix(written);
+        length += written;
+    }
+    if (!FlushFileBuffers(file)) {
+        throw FileException("Не удалось сбросить журнал на диск: " + path);
+    }
+}
+
+void Journal::syncFile(const std::string& filePath) {
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw FileException("Не удалось открыть файл: " + filePath);
+    }
+    BOOL flushed = FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!flushed) {
+        throw FileException("Не удалось сбросить файл на диск: " + filePath);
+    }
+}
+
+void Journal::syncDirectory(const std::string&) {
+    // В NTFS изменения каталога журналируются файловой системой
+}
+#else
+void Journal::openFile(bool truncate) {
+    int flags = O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0);
+    descriptor = ::open(path.c_str(), flags, 0644);
+    if (descriptor < 0) {
+        throw FileException("Не удалось открыть журнал: " + path);
+    }
+}
+
+void Journal::closeFile() {
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+    generation = -1;
+}
+
+void Journal::write(std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(descriptor, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw FileException("Ошибка записи в журнал: " + path);
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+        length += static_cast<size_t>(written);
+    }
+    if (::fsync(descriptor) != 0) {
+        throw FileException("Не удалось сбросить журнал на диск: " + path);
+    }
+}
+
+void Journal::syncFile(const std::string& filePath) {
+    int file = ::open(filePath.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw FileException("Не удалось открыть файл: " + filePath);
+    }
+    int result = ::fsync(file);
+    ::close(file);
+    if (result != 0) {
+        throw FileException("Не удалось сбросить файл на диск: " + filePath);
+    }
+}
+
+void Journal::syncDirectory(const std::string& directoryPath) {
+    int directory = ::open(directoryPath.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory < 0) {
+        throw FileException("Не удалось открыть каталог: " + directoryPath);
+    }
+    int result = ::fsync(directory);
+    ::close(directory);
+    if (result != 0) {
+        throw FileException("Не удалось сбросить каталог на диск: " + directoryPath);
+    }
+}
+#endif
@@ -3,7 +3,12 @@
 
 Librarian::Librarian(int pId, std::string_view pName, std::string_view pSurname,
                      std::string_view pPhone, double pSalary, int pWorkHours)
-    : Employee(pId, pName, pSurname, pPhone, "Librarian", pSalary, pWorkHours) {
+    : Employee(pId, pName, pSurname, pPhone, positionKey(), pSalary, pWorkHours) {
+}
+
+InternedString Librarian::positionKey() {
+    static const InternedString key("Librarian");
+    return key;
 }
 
 double Librarian::calculateMonthlySalary() const {
@@ -1,72 +1,251 @@
 #include "librarycontainer.h"
 #include "exceptions.h"
 
-void LibraryContainer::addBook(std::unique_ptr<Book> book) {
-    if (findBookByIsbn(book->getIsbn()) != nullptr) {
+namespace {
+// Пустые слоты убираются, когда их больше половины (но не раньше этого порога)
+constexpr size_t MIN_HOLES_TO_COMPACT = 64;
+}
+
+void LibraryContainer::link(SlabHandle handle) {
+    Book* book = storage.get(handle);
+    if (idIndex.contains(book->getId())) {
+        throw DuplicateException("Книга с ID " + std::to_string(book->getId()) + " уже существует");
+    }
+    if (!isbnIndex.try_emplace(book->getIsbn(), book).second) {
         throw DuplicateException("Книга с ISBN " + book->getIsbn() + " уже существует");
     }
-    books.push_back(std::move(book));
+    idIndex.insert(book->getId(), books.size());
+    books.push_back({book, handle});
+    columns.append(*book);
+    textIndex.append(*book);
+    titleIndex.set(book->getId(), book->getTitle());
 }
 
 void LibraryContainer::removeBook(int id) {
-    auto it = std::find_if(books.begin(), books.end(),
-                          [id](const std::unique_ptr<Book>& book) {
-                              return book->getId() == id;
-                          });
-    if (it != books.end()) {
-        books.erase(it);
-    } else {
+    size_t pos = idIndex.find(id);
+    if (pos == IdIndex::npos) {
         throw NotFoundException("Книга с ID " + std::to_string(id));
     }
+    isbnIndex.erase(books[pos].book->getIsbn());
+    titleIndex.erase(id);
+    // Слот не сдвигается: остальные книги сохраняют позиции и порядок
+    storage.erase(books[pos].handle);
+    books[pos] = {nullptr, SlabHandle{}};
+    columns.erase(pos);
+    textIndex.erase(pos);
+    idIndex.erase(id);
+    ++holes;
+    if (holes >= MIN_HOLES_TO_COMPACT && holes * 2 > books.size()) {
+        compact();
+    }
+}
+
+void LibraryContainer::compact() {
+    auto newEnd = std::remove_if(books.begin(), books.end(), [](const Slot& slot) { return !slot.book; });
+    books.erase(newEnd, books.end());
+    holes = 0;
+    for (size_t i = 0; i < books.size(); ++i) {
+        idIndex.insert(books[i].book->getId(), i);
+    }
+    rebuildColumns();
+}
+
+void LibraryContainer::finishBulkLoad(std::vector<std::string>& problems) {
+    // В индексе пока только книги, бывшие до загрузки: они остаются первыми, загруженные - за ними
+    bulkStart = idIndex.size();
+    idIndex.clear();
+    isbnIndex.clear();
+    isbnIndex.reserve(books.size());
+    std::vector<Slot> kept;
+    kept.reserve(books.size());
+    // Из повторяющихся записей остаётся первая, как если бы книги добавлялись через addBook
+    for (const Slot& slot : books) {
+        if (!slot.book) continue;
+        Book* book = slot.book;
+        if (idIndex.contains(book->getId())) {
+            problems.push_back("Книга с ID " + std::to_string(book->getId()) + " встречается повторно, запись пропущена");
+        } else if (!isbnIndex.try_emplace(book->getIsbn(), book).second) {
+            problems.push_back("Книга с ID " + std::to_string(book->getId()) + ": ISBN " + book->getIsbn() + " уже есть у другой книги, запись пропущена");
+        } else {
+            idIndex.insert(book->getId(), kept.size());
+            kept.push_back(slot);
+            continue;
+        }
+        storage.erase(slot.handle);
+    }
+    books.swap(kept);
+    holes = 0;
+    std::vector<std::pair<int, std::string>> titles;
+    titles.reserve(books.size());
+    for (const Slot& slot : books) {
+        titles.emplace_back(slot.book->getId(), slot.book->getTitle());
+    }
+    titleIndex.assign(titles);
 }
 
-Book* LibraryContainer::findBook(int id) {
-    auto it = std::find_if(books.begin(), books.end(),
-                          [id](const std::unique_ptr<Book>& book) {
-                              return book->getId() == id;
-                          });
-    return (it != books.end()) ? it->get() : nullptr;
+void LibraryContainer::reserve(size_t count) {
+    storage.reserve(count);
+    books.reserve(count);
 }
 
-const Book* LibraryContainer::findBook(int id) const {
-    auto it = std::find_if(books.begin(), books.end(),
-                          [id](const std::unique_ptr<Book>& book) {
-                              return book->getId() == id;
-                          });
-    return (it != books.end()) ? it->get() : nullptr;
+void LibraryContainer::rebuildColumns() {
+    columns.clear();
+    columns.reserve(books.size());
+    textIndex.clear();
+    textIndex.reserve(books.size());
+    for (size_t i = 0; i < books.size(); ++i) {
+        if (books[i].book) {
+            columns.append(*books[i].book);
+            textIndex.append(*books[i].book);
+        } else {
+            columns.appendEmpty();
+            textIndex.appendEmpty();
+        }
+    }
 }
 
 Book* LibraryContainer::findBookByIsbn(std::string_view isbn) {
-    auto it = std::find_if(books.begin(), books.end(),
-                          [&isbn](const std::unique_ptr<Book>& book) {
-                              return book->getIsbn() == isbn;
-                          });
-    return (it != books.end()) ? it->get() : nullptr;
+    auto it = isbnIndex.find(isbn);
+    return (it != isbnIndex.end()) ? it->second : nullptr;
 }
 
 const Book* LibraryContainer::findBookByIsbn(std::string_view isbn) const {
-    auto it = std::find_if(books.begin(), books.end(),
-                          [&isbn](const std::unique_ptr<Book>& book) {
-                              return book->getIsbn() == isbn;
-                          });
-    return (it != books.end()) ? it->get() : nullptr;
+    auto it = isbnIndex.find(isbn);
+    return (it != isbnIndex.end()) ? it->second : nullptr;
+}
+
+void LibraryContainer::changeIsbn(int id, std::string_view isbn) {
+    size_t pos = idIndex.find(id);
+    if (pos == IdIndex::npos) {
+        throw NotFoundException("Книга с ID " + std::to_string(id));
+    }
+    Book* book = books[pos].book;
+    if (book->getIsbn() == isbn) {
+        return;
+    }
+    if (isbnIndex.count(isbn)) {
+        throw DuplicateException("Книга с ISBN " + std::string(isbn) + " уже существует");
+    }
+    // Ключ указывает на строку книги, поэтому запись переносится после смены строки
+    isbnIndex.erase(book->getIsbn());
+    book->setIsbn(isbn);
+    isbnIndex.emplace(book->getIsbn(), book);
+    columns.update(pos, *book); // ISBN в TextIndex не входит
+}
+
+void LibraryContainer::changeIsbns(const std::vector<std::pair<int, std::string_view>>& changes) {
+    struct Change {
+        size_t pos;
+        std::string_view isbn;
+        bool applied;
+    };
+    std::vector<Change> pending;
+    std::unordered_map<const Book*, size_t> byBook; // Книга -> её смена в pending
+    for (const auto& [id, isbn] : changes) {
+        size_t pos = idIndex.find(id);
+        if (pos == IdIndex::npos || books[pos].book->getIsbn() == isbn || byBook.count(books[pos].book)) {
+            continue;
+        }
+        byBook.emplace(books[pos].book, pending.size());
+        pending.push_back({pos, isbn, false});
+    }
+    
+    for (const Change& change : pending) {
+        isbnIndex.erase(books[change.pos].book->getIsbn());
+    }
+    std::vector<size_t> rejected;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        pending[i].applied = isbnIndex.try_emplace(pending[i].isbn, books[pending[i].pos].book).second;
+        if (!pending[i].applied) {
+            rejected.push_back(i);
+        }
+    }
+    // Отклонённые книги возвращают старый ISBN. Если его уже заняла другая книга из этого
+    // шага, её смена тоже отменяется - и так по цепочке
+    while (!rejected.empty()) {
+        Book* book = books[pending[rejected.back()].pos].book;
+        rejected.pop_back();
+        auto [it, inserted] = isbnIndex.try_emplace(book->getIsbn(), book);
+        if (!inserted) {
+            size_t holder = byBook.at(it->second);
+            pending[holder].applied = false;
+            rejected.push_back(holder);
+            it->second = book;
+        }
+    }
+    
+    // Ключи новых ISBN пока указывают на строки из changes: переносим их на строки книг
+    for (const Change& change : pending) {
+        Book* book = books[change.pos].book;
+        if (change.applied) {
+            book->setIsbn(change.isbn);
+            columns.update(change.pos, *book); // ISBN в TextIndex не входит
+        }
+        isbnIndex.erase(book->getIsbn());
+        isbnIndex.emplace(book->getIsbn(), book);
+    }
+}
+
+void LibraryContainer::syncBook(int id) {
+    size_t pos = idIndex.find(id);
+    if (pos != IdIndex::npos) {
+        columns.update(pos, *books[pos].book);
+        textIndex.update(pos, *books[pos].book);
+        titleIndex.set(id, books[pos].book->getTitle());
+    }
+}
+
+void LibraryContainer::syncAvailability(int id) {
+    size_t pos = idIndex.find(id);
+    if (pos != IdIndex::npos) {
+        columns.setAvailable(pos, books[pos].book->isAvailable());
+    }
+}
+
+std::vector<Book*> LibraryContainer::selectBooks(const CatalogColumns::Query& query) const {
+    std::vector<std::string> words;
+    TextIndex::tokenize(query.text, words);
+    std::vector<size_t> rows;
+    if (words.empty()) {
+        rows = columns.select(query);
+    } else {
+        // Сначала строки со словами запроса из индекса, затем остальные условия только по ним
+        std::vector<size_t> candidates = textIndex.search(words);
+        rows = columns.select(query, &candidates);
+    }
+    std::vector<Book*> result;
+    result.reserve(rows.size());
+    for (size_t row : rows) {
+        result.push_back(books[row].book);
+    }
+    return result;
+}
+
+std::vector<Book*> LibraryContainer::suggestBooks(std::string_view prefix, size_t limit) const {
+    std::vector<Book*> result;
+    for (int id : titleIndex.find(prefix, limit)) {
+        result.push_back(books[idIndex.find(id)].book);
+    }
+    return result;
 }
 
 std::vector<Book*> LibraryContainer::getAllBooks() const {
     std::vector<Book*> result;
-    for (const auto& book : books) {
-        result.push_back(book.get());
+    result.reserve(size());
+    for (const auto& slot : books) {
+        if (slot.book) {
+            result.push_back(slot.book);
+        }
     }
     return result;
 }
 
 std::vector<Book*> LibraryContainer::getAvailableBooks() const {
     std::vector<Book*> result;
-    for (const auto& book : books) {
-        if (book->isAvailable()) {
-            result.push_back(book.get());
+    for (const auto& slot : books) {
+        if (slot.book && slot.book->isAvailable()) {
+            result.push_back(slot.book);
         }
     }
     return result;
 }
-
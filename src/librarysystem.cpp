@@ -2,6 +2,7 @@
 #include "exceptions.h"
 #include "commands.h"
 #include <algorithm>
+#include <unordered_map>
 
 LibrarySystem::LibrarySystem() = default;
 
@@ -62,16 +63,20 @@ std::vector<Book*> LibrarySystem::getAllBooks() const {
     return books.getAllBooks();
 }
 
+std::vector<Book*> LibrarySystem::findBooks(const CatalogColumns::Query& query) const {
+    return books.selectBooks(query);
+}
+
+std::vector<Book*> LibrarySystem::suggestBooks(std::string_view prefix, size_t limit) const {
+    return books.suggestBooks(prefix, limit);
+}
+
 std::vector<Book*> LibrarySystem::getAvailableBooks() const {
     std::vector<Book*> result;
-    for (auto* book : books.getAllBooks()) {
-        // Проверяем доступность с учетом количества экземпляров и ручной блокировки
-        if (book->getManuallyDisabled()) {
-            continue; // Пропускаем книги, заблокированные вручную
-        }
-        // Проверяем, есть ли доступные экземпляры
-        if (book->getQuantity() > 0) {
-            result.push_back(book);
+    for (Book& book : books) {
+        // Учитываем количество экземпляров и ручную блокировку
+        if (book.canBeBorrowed()) {
+            result.push_back(&book);
         }
     }
     return result;
@@ -85,6 +90,14 @@ const Book* LibrarySystem::findBook(int id) const {
     return books.findBook(id);
 }
 
+Book* LibrarySystem::findBookByIsbn(std::string_view isbn) {
+    return books.findBookByIsbn(isbn);
+}
+
+const Book* LibrarySystem::findBookByIsbn(std::string_view isbn) const {
+    return books.findBookByIsbn(isbn);
+}
+
 int LibrarySystem::addMember(std::string_view name, std::string_view surname, std::string_view phone, std::string_view email) {
     try {
         int id = members.generateId();
@@ -159,6 +172,14 @@ std::vector<LibraryMember*> LibrarySystem::getBlockedMembers() const {
     return members.getBlockedMembers();
 }
 
+std::vector<LibraryMember*> LibrarySystem::findMembers(const MemberContainer::Query& query) const {
+    return members.selectMembers(query);
+}
+
+std::vector<LibraryMember*> LibrarySystem::suggestMembers(std::string_view prefix, size_t limit) const {
+    return members.suggestMembers(prefix, limit);
+}
+
 void LibrarySystem::borrowBook(int memberId, int bookId, int employeeId) {
     LibraryMember* member = findMember(memberId);
     if (!member) {
@@ -171,26 +192,24 @@ void LibrarySystem::borrowBook(int memberId, int bookId, int employeeId) {
     }
     
     // Проверяем доступность на основе количества экземпляров
-    if (book->getManuallyDisabled() || book->getQuantity() <= 0) {
+    if (!book->canBeBorrowed()) {
         throw LibraryException("Book is not available");
     }
     
     // Проверяем существование работника
-    const Employee* employee = nullptr;
-    for (const auto* emp : getAllEmployees()) {
-        if (emp->getId() == employeeId) {
-            employee = emp;
-            break;
-        }
-    }
-    if (!employee) {
+    if (const Employee* employee = findEmployee(employeeId); !employee) {
         throw NotFoundException("Работник с ID " + std::to_string(employeeId));
     }
     
     try {
-        member->borrowBook(bookId, employeeId);
-        // Уменьшаем количество экземпляров при выдаче
-        book->setQuantity(book->getQuantity() - 1);
+        member->borrowBook(loans, bookId);
+        Date today = Date::today();
+        Date dueDate = today.addDays(LoanStore::LOAN_PERIOD_DAYS);
+        LoanStore::LoanId loanId = loans.add(memberId, BorrowedBook(bookId, today, dueDate, employeeId));
+        dueIndex.add(dueDate, loanId);
+        if (changeListener) changeListener->loanChanged(loanId, memberId);
+        // Экземпляр переходит на руки, общее количество не меняется
+        book->lendCopy();
         // Обновляем доступность после выдачи
         updateBookAvailability(bookId);
     } catch (const LibraryException&) {
@@ -211,9 +230,15 @@ void LibrarySystem::returnBook(int memberId, int bookId) {
     }
     
     try {
-        member->returnBook(bookId);
-        // Увеличиваем количество экземпляров при возврате
-        book->setQuantity(book->getQuantity() + 1);
+        LoanStore::LoanId loanId = loans.findOpen(memberId, bookId);
+        if (loanId == LoanStore::npos) {
+            throw NotFoundException("Взятая книга не найдена");
+        }
+        dueIndex.remove(loans.get(loanId).returnDate, loanId);
+        loans.close(loanId, Date::today());
+        if (changeListener) changeListener->loanChanged(loanId, memberId);
+        // Экземпляр возвращается в наличие
+        book->returnCopy();
         // Обновляем доступность после возврата
         updateBookAvailability(bookId);
     } catch (const LibraryException&) {
@@ -227,18 +252,55 @@ std::vector<BorrowedBook> LibrarySystem::getMemberBooks(int memberId) const {
     if (!member) {
         throw NotFoundException("Абонент с ID " + std::to_string(memberId));
     }
-    return member->getBorrowedBooks();
+    return loans.collect(loans.getMemberLoans(memberId));
+}
+
+LoanStore::LoanView LibrarySystem::getMemberLoans(int memberId) const {
+    if (!members.findMember(memberId)) {
+        throw NotFoundException("Абонент с ID " + std::to_string(memberId));
+    }
+    return loans.view(loans.getMemberLoans(memberId));
 }
 
 std::vector<std::pair<const LibraryMember*, BorrowedBook>> LibrarySystem::getOverdueBooks() const {
-    std::vector<std::pair<const LibraryMember*, BorrowedBook>> overdue;
-    for (const auto* member : getAllMembers()) {
-        auto memberOverdue = member->getOverdueBooks();
-        for (const auto& book : memberOverdue) {
-            overdue.emplace_back(member, book);
+    return resolveLoans(dueIndex.getOverdue(Date::today()));
+}
+
+std::vector<std::pair<const LibraryMember*, BorrowedBook>> LibrarySystem::getBooksDueWithin(int days) const {
+    Date today = Date::today();
+    return resolveLoans(dueIndex.getDueBetween(today.addDays(1), today.addDays(days)));
+}
+
+size_t LibrarySystem::getOverdueCount() const {
+    return dueIndex.countOverdue(Date::today());
+}
+
+std::vector<std::pair<const LibraryMember*, BorrowedBook>> LibrarySystem::resolveLoans(const std::vector<OverdueIndex::Entry>& entries) const {
+    std::vector<std::pair<const LibraryMember*, BorrowedBook>> result;
+    result.reserve(entries.size());
+    for (const auto& entry : entries) {
+        const BorrowedBook& loan = loans.get(entry.loanId);
+        if (const LibraryMember* member = findMember(loan.memberId)) {
+            result.emplace_back(member, loan);
+        }
+    }
+    return result;
+}
+
+std::vector<const LibraryMember*> LibrarySystem::getBookHolders(int bookId) const {
+    std::vector<const LibraryMember*> result;
+    for (LoanStore::LoanId id : loans.getBookLoans(bookId)) {
+        const BorrowedBook& loan = loans.get(id);
+        if (loan.returned) continue;
+        if (const LibraryMember* member = findMember(loan.memberId)) {
+            result.push_back(member);
         }
     }
-    return overdue;
+    return result;
+}
+
+std::vector<BorrowedBook> LibrarySystem::getEmployeeLoans(int employeeId) const {
+    return loans.collect(loans.getEmployeeLoans(employeeId));
 }
 
 void LibrarySystem::addLibrarian(std::string_view name, std::string_view surname,
@@ -269,14 +331,7 @@ void LibrarySystem::addManager(std::string_view name, std::string_view surname,
 
 void LibrarySystem::editEmployee(int id, std::string_view name, std::string_view surname,
                                  std::string_view phone, double salary, int workHours) {
-    const Employee* emp = nullptr;
-    for (const auto* e : getAllEmployees()) {
-        if (e->getId() == id) {
-            emp = e;
-            break;
-        }
-    }
-    if (!emp) {
+    if (const Employee* emp = findEmployee(id); !emp) {
         throw NotFoundException("Работник с ID " + std::to_string(id));
     }
     
@@ -290,14 +345,7 @@ void LibrarySystem::editEmployee(int id, std::string_view name, std::string_view
 }
 
 void LibrarySystem::removeEmployee(int id) {
-    const Employee* emp = nullptr;
-    for (const auto* e : getAllEmployees()) {
-        if (e->getId() == id) {
-            emp = e;
-            break;
-        }
-    }
-    if (!emp) {
+    if (const Employee* emp = findEmployee(id); !emp) {
         throw NotFoundException("Работник с ID " + std::to_string(id));
     }
     
@@ -310,12 +358,16 @@ void LibrarySystem::removeEmployee(int id) {
     }
 }
 
+Employee* LibrarySystem::findEmployee(int id) const {
+    return employees.findEmployee(id);
+}
+
 std::vector<Employee*> LibrarySystem::getAllEmployees() const {
-    std::vector<Employee*> result;
-    for (const auto& emp : employees) {
-        result.push_back(emp.get());
-    }
-    return result;
+    return employees.getAllEmployees();
+}
+
+std::vector<Employee*> LibrarySystem::suggestEmployees(std::string_view prefix, size_t limit) const {
+    return employees.suggestEmployees(prefix, limit);
 }
 
 // Undo/Redo для книг
@@ -369,20 +421,32 @@ bool LibrarySystem::canRedoEmployees() const {
     return commandManagerEmployees.canRedo();
 }
 
-void LibrarySystem::addBookWithId(int id, std::string_view title, std::string_view author,
+Book& LibrarySystem::addBookWithId(int id, std::string_view title, std::string_view author,
                                    std::string_view isbn, int year, std::string_view genre, bool available,
                                    std::string_view coverPath, int quantity,
                                    std::string_view description, std::string_view pdfPath) {
-    auto book = std::make_unique<Book>(id, title, author, isbn, year, genre, coverPath, quantity, description, pdfPath);
-    book->setAvailable(available);
     if (id >= nextBookId) {
         nextBookId = id + 1;
     }
-    books.addBook(std::move(book));
+    if (bulkLoading) {
+        Book& book = books.appendBook(id, title, author, isbn, year, genre, coverPath, quantity, description, pdfPath);
+        book.setAvailable(available);
+        return book;
+    }
+    Book& book = books.addBook(id, title, author, isbn, year, genre, coverPath, quantity, description, pdfPath);
+    book.setAvailable(available);
+    books.syncBook(id);
+    if (changeListener) changeListener->bookChanged(id);
+    return book;
 }
 
 void LibrarySystem::removeBookDirect(int id) {
     books.removeBook(id);
+    if (changeListener) changeListener->bookRemoved(id);
+}
+
+void LibrarySystem::changeBookIsbns(const std::vector<std::pair<int, std::string_view>>& changes) {
+    books.changeIsbns(changes);
 }
 
 void LibrarySystem::editBookDirect(int id, std::string_view title, std::string_view author,
@@ -394,32 +458,52 @@ void LibrarySystem::editBookDirect(int id, std::string_view title, std::string_v
         throw NotFoundException("Книга с ID " + std::to_string(id));
     }
     
+    // ISBN меняется через контейнер, чтобы индекс оставался согласованным
+    books.changeIsbn(id, isbn);
     book->setTitle(title);
     book->setAuthor(author);
-    book->setIsbn(isbn);
     book->setYear(year);
     book->setGenre(genre);
     book->setCoverPath(coverPath);
     book->setQuantity(quantity);
     book->setDescription(description);
     book->setPdfPath(pdfPath);
+    books.syncBook(id);
+    if (changeListener) changeListener->bookChanged(id);
 }
 
 void LibrarySystem::addMemberWithId(int id, std::string_view name, std::string_view surname, 
                                      std::string_view phone, bool blocked, std::string_view email) {
-    auto member = std::make_unique<LibraryMember>(id, name, surname, phone, email);
-    member->setBlocked(blocked);
     if (id >= members.getNextId()) {
         members.setNextId(id + 1);
     }
-    members.addMember(std::move(member));
+    LibraryMember& member = bulkLoading ? members.appendMember(id, name, surname, phone, email)
+                                        : members.addMember(id, name, surname, phone, email);
+    member.setBlocked(blocked);
+    if (changeListener && !bulkLoading) changeListener->memberChanged(id);
 }
 
 void LibrarySystem::removeMemberDirect(int id) {
+    if (!findMember(id)) {
+        throw NotFoundException("Абонент с ID " + std::to_string(id));
+    }
+    // Невозвращённые книги абонента перестают учитываться как выданные
+    for (LoanStore::LoanId loanId : loans.getMemberOpenLoans(id)) {
+        const BorrowedBook& loan = loans.get(loanId);
+        dueIndex.remove(loan.returnDate, loanId);
+        if (Book* book = findBook(loan.bookId)) {
+            book->setActiveLoans(book->getActiveLoans() - 1);
+        }
+    }
+    loans.removeMember(id);
     members.removeMember(id);
+    if (changeListener) changeListener->memberRemoved(id);
+    if (loans.needsCompaction()) {
+        compactLoans();
+    }
 }
 
-void LibrarySystem::editMemberDirect(int id, std::string_view name, std::string_view surname, std::string_view phone, std::string_view email) const {
+void LibrarySystem::editMemberDirect(int id, std::string_view name, std::string_view surname, std::string_view phone, std::string_view email) {
     LibraryMember* member = findMember(id);
     if (!member) {
         throw NotFoundException("Абонент с ID " + std::to_string(id));
@@ -428,6 +512,8 @@ void LibrarySystem::editMemberDirect(int id, std::string_view name, std::string_
     member->setSurname(surname);
     member->setPhone(phone);
     member->setEmail(email);
+    members.syncMember(id);
+    if (changeListener) changeListener->memberChanged(id);
 }
 
 void LibrarySystem::blockMemberDirect(int id) const {
@@ -436,6 +522,7 @@ void LibrarySystem::blockMemberDirect(int id) const {
         throw NotFoundException("Абонент с ID " + std::to_string(id));
     }
     member->setBlocked(true);
+    if (changeListener) changeListener->memberChanged(id);
 }
 
 void LibrarySystem::unblockMemberDirect(int id) const {
@@ -444,41 +531,30 @@ void LibrarySystem::unblockMemberDirect(int id) const {
         throw NotFoundException("Абонент с ID " + std::to_string(id));
     }
     member->setBlocked(false);
+    if (changeListener) changeListener->memberChanged(id);
 }
 
 void LibrarySystem::addEmployeeWithId(int id, std::string_view name, std::string_view surname,
                                       std::string_view phone, double salary, int workHours, bool isLibrarian) {
     if (isLibrarian) {
-        employees.emplace_back(std::make_unique<Librarian>(id, name, surname, phone, salary, workHours));
+        employees.addEmployee(std::make_unique<Librarian>(id, name, surname, phone, salary, workHours));
     } else {
-        employees.emplace_back(std::make_unique<Manager>(id, name, surname, phone, salary, workHours));
+        employees.addEmployee(std::make_unique<Manager>(id, name, surname, phone, salary, workHours));
     }
     if (id >= nextEmployeeId) {
         nextEmployeeId = id + 1;
     }
+    if (changeListener) changeListener->employeeChanged(id);
 }
 
 void LibrarySystem::removeEmployeeDirect(int id) {
-    auto it = std::find_if(employees.begin(), employees.end(),
-                          [id](const std::unique_ptr<Employee>& emp) {
-                              return emp->getId() == id;
-                          });
-    if (it != employees.end()) {
-        employees.erase(it);
-    } else {
-        throw NotFoundException("Работник с ID " + std::to_string(id));
-    }
+    employees.removeEmployee(id);
+    if (changeListener) changeListener->employeeRemoved(id);
 }
 
 void LibrarySystem::editEmployeeDirect(int id, std::string_view name, std::string_view surname,
-                                       std::string_view phone, double salary, int workHours) const {
-    Employee* emp = nullptr;
-    for (const auto& e : employees) {
-        if (e->getId() == id) {
-            emp = e.get();
-            break;
-        }
-    }
+                                       std::string_view phone, double salary, int workHours) {
+    Employee* emp = findEmployee(id);
     if (!emp) {
         throw NotFoundException("Работник с ID " + std::to_string(id));
     }
@@ -488,48 +564,186 @@ void LibrarySystem::editEmployeeDirect(int id, std::string_view name, std::strin
     emp->setPhone(phone);
     emp->setSalary(salary);
     emp->setWorkHours(workHours);
-}
-
-void LibrarySystem::addBorrowedBook(int memberId, int bookId, std::string_view borrowDate, 
-                                    std::string_view returnDate, bool returned, int employeeId) {
+    employees.syncEmployee(id);
+    if (changeListener) changeListener->employeeChanged(id);
+}
+
+void LibrarySystem::addBorrowedBook(int memberId, int bookId, Date borrowDate, 
+                                    Date returnDate, bool returned, int employeeId) {
+    BorrowedBook loan(bookId, borrowDate, returnDate, employeeId);
+    loan.returned = returned;
+    loan.memberId = memberId;
+    if (bulkLoading) {
+        // Абонент и книга проверяются в endBulkLoad, когда индексы уже построены
+        pendingLoans.push_back(loan);
+        return;
+    }
+    
     LibraryMember* member = findMember(memberId);
     if (!member) {
         throw NotFoundException("Абонент с ID " + std::to_string(memberId));
     }
     
-    if (const Book* book = findBook(bookId); !book) {
+    Book* book = findBook(bookId);
+    if (!book) {
         throw NotFoundException("Книга с ID " + std::to_string(bookId));
     }
     
-    member->borrowBookWithDate(bookId, borrowDate, returnDate, returned, employeeId);
+    LoanStore::LoanId loanId = attachLoan(*member, *book, loan);
+    if (changeListener) changeListener->loanChanged(loanId, memberId);
     // Обновляем доступность после загрузки
     updateBookAvailability(bookId);
 }
 
+void LibrarySystem::restoreLoan(int memberId, size_t index, const BorrowedBook& loan) {
+    LibraryMember* member = findMember(memberId);
+    if (!member) {
+        throw NotFoundException("Абонент с ID " + std::to_string(memberId));
+    }
+    
+    const std::vector<LoanStore::LoanId>& history = loans.getMemberLoans(memberId);
+    if (index > history.size()) {
+        throw DataException("выдача " + std::to_string(index) + " абонента " + std::to_string(memberId) +
+                            ": в истории только " + std::to_string(history.size()) + " записей");
+    }
+    
+    if (index == history.size()) {
+        Book* book = findBook(loan.bookId);
+        if (!book) {
+            throw NotFoundException("Книга с ID " + std::to_string(loan.bookId));
+        }
+        BorrowedBook added = loan;
+        added.memberId = memberId;
+        LoanStore::LoanId loanId = attachLoan(*member, *book, added);
+        if (changeListener) changeListener->loanChanged(loanId, memberId);
+        updateBookAvailability(loan.bookId);
+        return;
+    }
+    
+    // Запись уже есть: меняться может только отметка о возврате.
+    // Количество экземпляров не трогаем - его восстанавливает запись книги
+    LoanStore::LoanId loanId = history[index];
+    const BorrowedBook& current = loans.get(loanId);
+    if (!loan.returned || current.returned) {
+        return;
+    }
+    int bookId = current.bookId;
+    dueIndex.remove(current.returnDate, loanId);
+    loans.close(loanId, loan.returnDate);
+    if (Book* book = findBook(bookId)) {
+        book->setActiveLoans(book->getActiveLoans() - 1);
+    }
+    if (changeListener) changeListener->loanChanged(loanId, memberId);
+    updateBookAvailability(bookId);
+}
+
+LoanStore::LoanId LibrarySystem::attachLoan(LibraryMember& member, Book& book, const BorrowedBook& loan) {
+    LoanStore::LoanId loanId = loans.add(member.getId(), loan);
+    // Количество в файле уже учитывает выданные экземпляры, меняется только счётчик
+    if (!loan.returned) {
+        book.setActiveLoans(book.getActiveLoans() + 1);
+        // Записи без срока возврата не могут быть просрочены
+        if (!loan.returnDate.isNull()) {
+            dueIndex.add(loan.returnDate, loanId);
+        }
+    }
+    return loanId;
+}
+
+void LibrarySystem::compactLoans() {
+    std::vector<LoanStore::LoanId> newIds = loans.compact();
+    dueIndex.clear();
+    for (LoanStore::LoanId loanId : loans.getOpenLoans()) {
+        const BorrowedBook& loan = loans.get(loanId);
+        if (!loan.returnDate.isNull()) {
+            dueIndex.add(loan.returnDate, loanId);
+        }
+    }
+    if (changeListener) changeListener->loansRenumbered(newIds);
+}
+
+void LibrarySystem::beginBulkLoad(size_t bookCount, size_t memberCount, size_t loanCount) {
+    bulkLoading = true;
+    pendingLoans.clear();
+    books.reserve(books.size() + bookCount);
+    members.reserve(members.size() + memberCount);
+    pendingLoans.reserve(loanCount);
+}
+
+std::vector<std::string> LibrarySystem::endBulkLoad() {
+    std::vector<std::string> problems;
+    if (!bulkLoading) {
+        return problems;
+    }
+    bulkLoading = false;
+    
+    books.finishBulkLoad(problems);
+    members.finishBulkLoad(problems);
+    
+    // Выдачи - одним проходом: ссылки на несуществующих абонентов и книги отбрасываются.
+    // Выдача относится к записям той же загрузки: если абонент или книга с таким ID уже были
+    // в системе (а загруженная запись пропущена как повтор), чужая история к ним не добавляется
+    loans.reserve(loans.size() + pendingLoans.size(), members.size(), books.size());
+    for (const BorrowedBook& loan : pendingLoans) {
+        const char* reason = nullptr;
+        if (!members.isBulkLoaded(loan.memberId)) {
+            reason = findMember(loan.memberId) ? "абонент с таким ID уже был в системе" : "абонент не найден";
+        } else if (!books.isBulkLoaded(loan.bookId)) {
+            reason = findBook(loan.bookId) ? "книга с таким ID уже была в системе" : "книга не найдена";
+        }
+        if (reason) {
+            problems.push_back("Выдача книги " + std::to_string(loan.bookId) + " абоненту " + std::to_string(loan.memberId) + ": " +
+                               reason + ", запись пропущена");
+            continue;
+        }
+        attachLoan(*findMember(loan.memberId), *findBook(loan.bookId), loan);
+    }
+    pendingLoans.clear();
+    pendingLoans.shrink_to_fit();
+    
+    // Доступность и колонки каталога - один раз для всех книг, когда счётчики выдач известны
+    for (Book& book : books) {
+        book.setAvailable(book.canBeBorrowed());
+    }
+    books.rebuildColumns();
+    
+    // Инвариант: счётчики всех книг сходятся с историей выдач
+    for (int bookId : verifyLoanCounters()) {
+        problems.push_back("Книга " + std::to_string(bookId) + ": число выданных экземпляров не совпадает с историей выдач");
+    }
+    return problems;
+}
+
 int LibrarySystem::getBorrowedCount(int bookId) const {
-    int count = 0;
-    for (const auto* member : getAllMembers()) {
-        auto borrowedBooks = member->getBorrowedBooks();
-        for (const auto& borrowed : borrowedBooks) {
-            if (borrowed.bookId == bookId && !borrowed.returned) {
-                count++;
-            }
+    const Book* book = findBook(bookId);
+    return book ? book->getActiveLoans() : 0;
+}
+
+std::vector<int> LibrarySystem::verifyLoanCounters() const {
+    // Полный пересчёт по истории выдач - для проверки после загрузки (endBulkLoad) и отладки
+    std::unordered_map<int, int> openLoans;
+    for (LoanStore::LoanId id : loans.getOpenLoans()) {
+        openLoans[loans.get(id).bookId]++;
+    }
+    
+    std::vector<int> mismatched;
+    for (const Book& book : books) {
+        auto it = openLoans.find(book.getId());
+        int expected = (it != openLoans.end()) ? it->second : 0;
+        if (book.getActiveLoans() != expected || book.isAvailable() != book.canBeBorrowed()) {
+            mismatched.push_back(book.getId());
         }
     }
-    return count;
+    return mismatched;
 }
 
 void LibrarySystem::updateBookAvailability(int bookId) {
     Book* book = findBook(bookId);
     if (!book) return;
     
-    // Если книга заблокирована вручную, она недоступна
-    if (book->getManuallyDisabled()) {
-        book->setAvailable(false);
-        return;
-    }
-    
-    // Иначе проверяем количество доступных экземпляров
-    book->setAvailable(book->getQuantity() > 0);
+    // Книга доступна, если не заблокирована вручную и есть экземпляры в наличии
+    book->setAvailable(book->canBeBorrowed());
+    books.syncAvailability(bookId);
+    if (changeListener) changeListener->bookChanged(bookId);
 }
 
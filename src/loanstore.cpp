@@ -0,0 +1,172 @@
+#include "loanstore.h"
+#include <algorithm>
+
+namespace {
+// Записи удалённых абонентов убираются, когда их больше половины (но не раньше этого порога)
+constexpr size_t MIN_REMOVED_TO_COMPACT = 64;
+
+// Ключи, по которым записаны выдачи, - каждый по одному разу
+void sortUnique(std::vector<int>& keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+}
+
+const std::vector<LoanStore::LoanId>& LoanStore::lookup(const std::unordered_map<int, std::vector<LoanId>>& index, int key) {
+    static const std::vector<LoanId> empty;
+    auto it = index.find(key);
+    return (it != index.end()) ? it->second : empty;
+}
+
+LoanStore::LoanId LoanStore::add(int memberId, const BorrowedBook& loan) {
+    auto id = static_cast<LoanId>(loans.size());
+    loans.push_back(loan);
+    loans.back().memberId = memberId;
+    loans.back().removed = false;
+    byMember[memberId].push_back(id);
+    byBook[loan.bookId].push_back(id);
+    if (loan.employeeId > 0) {
+        byEmployee[loan.employeeId].push_back(id);
+    }
+    if (loan.returned) {
+        openPosition.push_back(npos);
+    } else {
+        openPosition.push_back(static_cast<LoanId>(openLoans.size()));
+        openLoans.push_back(id);
+        openByMember[memberId].push_back(id);
+    }
+    return id;
+}
+
+void LoanStore::markClosed(LoanId id) {
+    LoanId pos = openPosition[id];
+    if (pos == npos) return;
+    // Перемещаем последнюю открытую запись на место закрываемой
+    LoanId last = openLoans.back();
+    openLoans[pos] = last;
+    openPosition[last] = pos;
+    openLoans.pop_back();
+    openPosition[id] = npos;
+
+    auto memberIt = openByMember.find(loans[id].memberId);
+    if (memberIt != openByMember.end()) {
+        auto& open = memberIt->second;
+        open.erase(std::find(open.begin(), open.end(), id));
+        if (open.empty()) {
+            openByMember.erase(memberIt);
+        }
+    }
+}
+
+void LoanStore::close(LoanId id, Date returnDate) {
+    markClosed(id);
+    loans[id].returned = true;
+    loans[id].returnDate = returnDate;
+}
+
+LoanStore::LoanId LoanStore::findOpen(int memberId, int bookId) const {
+    for (LoanId id : getMemberOpenLoans(memberId)) {
+        if (loans[id].bookId == bookId) {
+            return id;
+        }
+    }
+    return npos;
+}
+
+void LoanStore::removeMember(int memberId) {
+    auto memberIt = byMember.find(memberId);
+    if (memberIt == byMember.end()) return;
+    const std::vector<LoanId>& history = memberIt->second;
+    std::vector<int> bookIds;
+    std::vector<int> employeeIds;
+    bookIds.reserve(history.size());
+    for (LoanId id : history) {
+        markClosed(id);
+        bookIds.push_back(loans[id].bookId);
+        if (loans[id].employeeId > 0) {
+            employeeIds.push_back(loans[id].employeeId);
+        }
+    }
+    sortUnique(bookIds);
+    sortUnique(employeeIds);
+    // Каждый список книги или работника проходится один раз, а не по разу на выдачу
+    auto eraseFrom = [this, memberId](std::unordered_map<int, std::vector<LoanId>>& index, const std::vector<int>& keys) {
+        for (int key : keys) {
+            auto it = index.find(key);
+            if (it == index.end()) continue;
+            auto& ids = it->second;
+            ids.erase(std::remove_if(ids.begin(), ids.end(), [this, memberId](LoanId id) { return loans[id].memberId == memberId; }),
+                      ids.end());
+            if (ids.empty()) {
+                index.erase(it);
+            }
+        }
+    };
+    eraseFrom(byBook, bookIds);
+    eraseFrom(byEmployee, employeeIds);
+    // Записи остаются в векторе (номера других записей не меняются) до compact()
+    for (LoanId id : history) {
+        loans[id].removed = true;
+    }
+    removedCount += history.size();
+    byMember.erase(memberIt);
+}
+
+bool LoanStore::needsCompaction() const {
+    return removedCount >= MIN_REMOVED_TO_COMPACT && removedCount * 2 > loans.size();
+}
+
+std::vector<LoanStore::LoanId> LoanStore::compact() {
+    std::vector<LoanId> newIds(loans.size(), npos);
+    LoanId next = 0;
+    for (LoanId id = 0; id < loans.size(); ++id) {
+        if (loans[id].removed) continue;
+        newIds[id] = next;
+        loans[next] = loans[id];
+        openPosition[next] = openPosition[id];
+        ++next;
+    }
+    loans.erase(loans.begin() + next, loans.end());
+    openPosition.resize(next);
+    removedCount = 0;
+    
+    // Порядок номеров сохраняется, поэтому списки остаются упорядоченными
+    for (LoanId& id : openLoans) {
+        id = newIds[id];
+    }
+    for (auto* index : {&byMember, &byBook, &byEmployee, &openByMember}) {
+        for (auto& [key, ids] : *index) {
+            for (LoanId& id : ids) {
+                id = newIds[id];
+            }
+        }
+    }
+    return newIds;
+}
+
+void LoanStore::clear() {
+    loans.clear();
+    openPosition.clear();
+    openLoans.clear();
+    byMember.clear();
+    byBook.clear();
+    byEmployee.clear();
+    openByMember.clear();
+    removedCount = 0;
+}
+
+void LoanStore::reserve(size_t count, size_t memberCount, size_t bookCount) {
+    loans.reserve(count);
+    openPosition.reserve(count);
+    byMember.reserve(memberCount);
+    byBook.reserve(bookCount);
+}
+
+std::vector<BorrowedBook> LoanStore::collect(const std::vector<LoanId>& ids) const {
+    std::vector<BorrowedBook> result;
+    result.reserve(ids.size());
+    for (LoanId id : ids) {
+        result.push_back(loans[id]);
+    }
+    return result;
+}
@@ -1,10 +1,40 @@
 #include "../include/mainwindow.h"
+#include "../include/filemanager.h"
+#include "../include/exceptions.h"
 #include <QApplication>
 #include <QDir>
 #include <QFont>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+// LibrarySystem --convert <откуда> <куда>: каталог с текстовыми файлами -> library.bin или обратно
+static int convertFiles(const std::string& source, const std::string& target)
+{
+    try {
+        std::vector<std::string> problems = std::filesystem::is_directory(source)
+            ? FileManager::convertTextToBinary(source, target)
+            : FileManager::convertBinaryToText(source, target);
+        for (const std::string& problem : problems) {
+            std::cerr << problem << '\n';
+        }
+        return 0;
+    } catch (const LibraryException& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
 
 int main(int argc, char *argv[])
 {
+    if (argc >= 2 && std::string(argv[1]) == "--convert") {
+        if (argc != 4) {
+            std::cerr << "Использование: " << argv[0] << " --convert <каталог|файл.bin> <файл.bin|каталог>\n";
+            return 2;
+        }
+        return convertFiles(argv[2], argv[3]);
+    }
+    
     QApplication app(argc, argv);
     
     // Устанавливаем приятный шрифт для всего приложения
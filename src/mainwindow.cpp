@@ -1,6 +1,7 @@
 #include "../include/mainwindow.h"
 #include "ui_mainwindow.h"
 #include "../include/exceptions.h"
+#include "../include/suggestionmodel.h"
 #include <QInputDialog>
 #include <QFileDialog>
 #include <QHeaderView>
@@ -29,12 +30,16 @@
 #include <QMap>
 #include <QToolBar>
 #include <QRadioButton>
-#include <QDate>
 #include <QList>
 #include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
+namespace {
+// Подсказок в выпадающем списке при вводе: больше всё равно не просматривают
+constexpr size_t SUGGESTION_LIMIT = 50;
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
       ui(std::make_unique<Ui::MainWindow>()) // NOSONAR - Qt requires initialization in constructor
@@ -50,11 +55,30 @@ MainWindow::MainWindow(QWidget *parent)
         dir.mkpath(dataPath);
     }
     
+    // Ошибки фоновой записи приходят из другого потока - показываем их в потоке интерфейса
+    autoSaver = std::make_unique<AutoSaver>(dataPath.toStdString(), [this](const std::string& message) {
+        QMetaObject::invokeMethod(this, [this, message]() {
+            showError(QString("Не удалось автоматически сохранить данные: %1").arg(QString::fromStdString(message)));
+        }, Qt::QueuedConnection);
+    });
+    autoSaveTimer = new QTimer(this);
+    autoSaveTimer->setSingleShot(true);
+    autoSaveTimer->setInterval(AUTOSAVE_DELAY_MS);
+    connect(autoSaveTimer, &QTimer::timeout, this, [this]() { submitAutoSave(); });
+    
     setupMenu();
     setupUI();
     
+    // Изменения после контрольной точки попадают в журнал и отмечают разделы для следующей
+    librarySystem.setChangeListener(&changeTracker);
     // Загружаем данные при старте, если они есть
     loadDataSilently();
+    // Изменения из журнала уже в нём; их разделы остаются отмеченными для контрольной точки
+    changeTracker.clear();
+    if (!QFile::exists(QString::fromStdString(FileManager::manifestPath(dataPath.toStdString())))) {
+        // Данные прежних версий: первая контрольная точка разбивает их на сегменты
+        changeTracker.markAllDirty();
+    }
 }
 
 MainWindow::~MainWindow()
@@ -93,6 +117,16 @@ void MainWindow::setupMenu()
     connect(loadBtn, &QPushButton::clicked, this, &MainWindow::onLoad);
     fileEditToolBar->addWidget(loadBtn);
     
+    auto* exportBtn = new QPushButton("Экспорт", this);
+    exportBtn->setToolTip("Выгрузить данные в текстовые файлы");
+    connect(exportBtn, &QPushButton::clicked, this, &MainWindow::onExportText);
+    fileEditToolBar->addWidget(exportBtn);
+    
+    auto* importBtn = new QPushButton("Импорт", this);
+    importBtn->setToolTip("Добавить данные из текстовых файлов");
+    connect(importBtn, &QPushButton::clicked, this, &MainWindow::onImportText);
+    fileEditToolBar->addWidget(importBtn);
+    
     fileEditToolBar->addSeparator();
     
     // Кнопки Правка
@@ -216,6 +250,7 @@ void MainWindow::setupBooksTab()
     QHBoxLayout* filtersLayout = nullptr;
     auto* filtersGroup = createFiltersGroup(booksTab, filtersLayout);
     
+    filtersLayout->addWidget(createLineEditFilter(filtersGroup, "Поиск по словам...", "textFilter", 220, &MainWindow::onFilterChanged));
     filtersLayout->addWidget(createLineEditFilter(filtersGroup, "Название...", "titleFilter", 220, &MainWindow::onFilterChanged));
     filtersLayout->addWidget(createLineEditFilter(filtersGroup, "Автор...", "authorFilter", 220, &MainWindow::onFilterChanged));
     filtersLayout->addWidget(createLineEditFilter(filtersGroup, "Жанр...", "genreFilter", 180, &MainWindow::onFilterChanged));
@@ -335,67 +370,19 @@ void MainWindow::refreshBooks()
     if (table == nullptr) return;
     
     table->setRowCount(0);
-    auto books = librarySystem.getAllBooks();
     
-    // Применяем все фильтры одновременно
-    for (const auto* book : books) {
-        bool matches = true;
-        
-        // Фильтр по названию
-        if (!bookFilters.title.isEmpty()) {
-            QString title = QString::fromStdString(book->getTitle()).toLower();
-            if (!title.contains(bookFilters.title.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по автору
-        if (matches && !bookFilters.author.isEmpty()) {
-            QString author = QString::fromStdString(book->getAuthor()).toLower();
-            if (!author.contains(bookFilters.author.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по жанру
-        if (matches && !bookFilters.genre.isEmpty()) {
-            QString genre = QString::fromStdString(book->getGenre()).toLower();
-            if (!genre.contains(bookFilters.genre.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по ISBN
-        if (matches && !bookFilters.isbn.isEmpty()) {
-            QString isbn = QString::fromStdString(book->getIsbn()).toLower();
-            if (!isbn.contains(bookFilters.isbn.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по году (от)
-        if (matches && bookFilters.yearFrom > 0 && book->getYear() < bookFilters.yearFrom) {
-            matches = false;
-        }
-        
-        // Фильтр по году (до)
-        if (matches && bookFilters.yearTo > 0 && book->getYear() > bookFilters.yearTo) {
-            matches = false;
-        }
-        
-        // Фильтр по доступности
-        if (matches && bookFilters.availability != -1) {
-            const bool isAvailable = book->isAvailable();
-            if ((bookFilters.availability == 1 && !isAvailable) ||
-                (bookFilters.availability == 0 && isAvailable)) {
-                matches = false;
-            }
-        }
-        
-        // Пропускаем книгу, если она не соответствует фильтрам
-        if (!matches) {
-            continue;
-        }
+    // Все фильтры сразу, по колонкам каталога (без обхода самих книг)
+    CatalogColumns::Query query;
+    query.text = bookFilters.text.toStdString();
+    query.title = bookFilters.title.toStdString();
+    query.author = bookFilters.author.toStdString();
+    query.genre = bookFilters.genre.toStdString();
+    query.isbn = bookFilters.isbn.toStdString();
+    query.yearFrom = bookFilters.yearFrom;
+    query.yearTo = bookFilters.yearTo;
+    query.availability = bookFilters.availability;
+    
+    for (const Book* book : librarySystem.findBooks(query)) {
         int row = table->rowCount();
         table->insertRow(row);
         
@@ -450,18 +437,21 @@ void MainWindow::refreshBooks()
         table->setCellWidget(row, 8, descriptionLabel);
         
         QString pdfPath = QString::fromStdString(book->getPdfPath());
+        SlabHandle handle = librarySystem.getBookHandle(book->getId()); // Указатель book не переживёт удаление книги
 
         // Колонка 9 - Действия (кнопки)
         auto* actionWidget = createActionWidget();
         auto* actionLayout = qobject_cast<QHBoxLayout*>(actionWidget->layout());
 
         // Кнопка "Инфо"
-        auto* infoBtn = createActionButton(style()->standardIcon(QStyle::SP_MessageBoxInformation), "Информация о книге", [this, book]() { onShowBookDetails(book->getId()); });
+        auto* infoBtn = createActionButton(style()->standardIcon(QStyle::SP_MessageBoxInformation), "Информация о книге", [this, handle]() { if (const Book* book = librarySystem.resolveBook(handle)) { onShowBookDetails(book->getId()); } });
         infoBtn->setProperty("row", row);
         actionLayout->addWidget(infoBtn);
 
         // Кнопка "Редактировать"
-        auto* editBtn = createActionButton(style()->standardIcon(QStyle::SP_FileDialogContentsView), "Редактировать книгу", [this, book]() {
+        auto* editBtn = createActionButton(style()->standardIcon(QStyle::SP_FileDialogContentsView), "Редактировать книгу", [this, handle]() {
+            const Book* book = librarySystem.resolveBook(handle);
+            if (!book) return;
             auto* booksTableWidget = findChild<QTableWidget*>("booksTable");
             if (booksTableWidget != nullptr) {
                 for (int r = 0; r < booksTableWidget->rowCount(); ++r) {
@@ -476,7 +466,9 @@ void MainWindow::refreshBooks()
         actionLayout->addWidget(editBtn);
 
         // Кнопка "Удалить"
-        auto* delBtn = createActionButton(createRedCrossIcon(), "Удалить книгу", [this, book]() {
+        auto* delBtn = createActionButton(createRedCrossIcon(), "Удалить книгу", [this, handle]() {
+            const Book* book = librarySystem.resolveBook(handle);
+            if (!book) return;
             int ret = QMessageBox::question(this, "Подтверждение удаления", QString("Вы уверены, что хотите удалить книгу '%1'?").arg(QString::fromStdString(book->getTitle())), QMessageBox::Yes | QMessageBox::No);
             if (ret == QMessageBox::Yes) {
                 executeWithRefresh([this, book]() { librarySystem.removeBook(book->getId()); }, "Книга успешно удалена");
@@ -504,58 +496,25 @@ void MainWindow::refreshBooks()
         borrowBtn->setIcon(style()->standardIcon(QStyle::SP_DialogApplyButton));
         borrowBtn->setIconSize(QSize(22, 22));
         borrowBtn->setToolTip("Выдать книгу");
-        connect(borrowBtn, &QPushButton::clicked, this, [this, book]() {
+        connect(borrowBtn, &QPushButton::clicked, this, [this, handle]() {
+            const Book* book = librarySystem.resolveBook(handle);
+            if (!book) return;
             QDialog dialog(this);
             dialog.setWindowTitle("Выдать книгу");
             QFormLayout form(&dialog);
             // Поиск по пользователям
-            auto* memberCombo = new QComboBox(&dialog);
-            memberCombo->setEditable(true);
-            QStringList memberList;
-            auto members = librarySystem.getAllMembers();
-            for (const auto* member : members) {
-                QString memberText = QString("%1 %2").arg(QString::fromStdString(member->getName())).arg(QString::fromStdString(member->getSurname()));
-                memberCombo->addItem(memberText, member->getId());
-                memberList << memberText;
-            }
-            auto* memberCompleter = new QCompleter(memberList, memberCombo);
-            memberCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-            memberCombo->setCompleter(memberCompleter);
-            form.addRow("Абонент:", memberCombo);
-
-            // Поиск по книгам
-            auto* bookCombo = new QComboBox(&dialog);
-            bookCombo->setEditable(true);
-            QStringList bookList;
-            auto allBooks = librarySystem.getAllBooks();
-            for (const auto* b : allBooks) {
-                QString bookText = QString::fromStdString(b->getTitle());
-                bookCombo->addItem(bookText, b->getId());
-                bookList << bookText;
-            }
-            // По умолчанию выбранная книга — та, по которой нажата кнопка
-            if (int idx = bookCombo->findData(book->getId()); idx >= 0) {
-                bookCombo->setCurrentIndex(idx);
-            }
-            auto* bookCompleter = new QCompleter(bookList, bookCombo);
-            bookCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-            bookCombo->setCompleter(bookCompleter);
-            form.addRow("Книга:", bookCombo);
+            auto* memberField = createLookupField(&dialog, memberSuggestions());
+            form.addRow("Абонент:", memberField);
+
+            // Поиск по книгам; по умолчанию выбранная книга — та, по которой нажата кнопка
+            auto* bookField = createLookupField(&dialog, bookSuggestions());
+            setLookupValue(bookField, QString::fromStdString(book->getTitle()), book->getId());
+            form.addRow("Книга:", bookField);
 
             // Поиск по работникам
-            auto* employeeCombo = new QComboBox(&dialog);
-            employeeCombo->setEditable(true);
-            QStringList employeeList;
-            auto employees = librarySystem.getAllEmployees();
-            for (const auto* emp : employees) {
-                QString empText = QString("%1 %2").arg(QString::fromStdString(emp->getName())).arg(QString::fromStdString(emp->getSurname()));
-                employeeCombo->addItem(empText, emp->getId());
-                employeeList << empText;
-            }
-            auto* empCompleter = new QCompleter(employeeList, employeeCombo);
-            empCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-            employeeCombo->setCompleter(empCompleter);
-            form.addRow("Работник:", employeeCombo);
+            auto* employeeField = createLookupField(&dialog, employeeSuggestions());
+            setDefaultEmployee(employeeField);
+            form.addRow("Работник:", employeeField);
 
             QDialogButtonBox buttonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dialog);
             form.addRow(&buttonBox);
@@ -563,9 +522,13 @@ void MainWindow::refreshBooks()
             connect(&buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
             if (dialog.exec() == QDialog::Accepted) {
                 try {
-                    int memberId = memberCombo->currentData().toInt();
-                    int bookId = bookCombo->currentData().toInt();
-                    int employeeId = employeeCombo->currentData().toInt();
+                    int memberId = lookupId(memberField);
+                    int bookId = lookupId(bookField);
+                    int employeeId = std::max(lookupId(employeeField), 0);
+                    if (memberId <= 0 || bookId <= 0) {
+                        showError("Пожалуйста, выберите абонента и книгу");
+                        return;
+                    }
                     librarySystem.borrowBook(memberId, bookId, employeeId);
                     refreshBooks();
                     refreshMembers();
@@ -597,6 +560,7 @@ void MainWindow::onSearchBooks(const QString& text)
 void MainWindow::onFilterChanged()
 {
     // Обновляем фильтры из полей ввода
+    const auto* textFilter = findChild<QLineEdit*>("textFilter");
     const auto* titleFilter = findChild<QLineEdit*>("titleFilter");
     const auto* authorFilter = findChild<QLineEdit*>("authorFilter");
     const auto* genreFilter = findChild<QLineEdit*>("genreFilter");
@@ -605,6 +569,7 @@ void MainWindow::onFilterChanged()
     const auto* yearToFilter = findChild<QSpinBox*>("yearToFilter");
     const auto* availabilityFilter = findChild<QComboBox*>("availabilityFilter");
     
+    if (textFilter) bookFilters.text = textFilter->text();
     if (titleFilter) bookFilters.title = titleFilter->text();
     if (authorFilter) bookFilters.author = authorFilter->text();
     if (genreFilter) bookFilters.genre = genreFilter->text();
@@ -622,6 +587,7 @@ void MainWindow::onClearFilters()
     bookFilters = BookFilters();
     
     // Очищаем поля ввода
+    auto* textFilter = findChild<QLineEdit*>("textFilter");
     auto* titleFilter = findChild<QLineEdit*>("titleFilter");
     auto* authorFilter = findChild<QLineEdit*>("authorFilter");
     auto* genreFilter = findChild<QLineEdit*>("genreFilter");
@@ -630,6 +596,7 @@ void MainWindow::onClearFilters()
     auto* yearToFilter = findChild<QSpinBox*>("yearToFilter");
     auto* availabilityFilter = findChild<QComboBox*>("availabilityFilter");
     
+    if (textFilter) textFilter->clear();
     if (titleFilter) titleFilter->clear();
     if (authorFilter) authorFilter->clear();
     if (genreFilter) genreFilter->clear();
@@ -714,60 +681,16 @@ void MainWindow::refreshMembers()
     if (membersTable == nullptr) return;
     
     membersTable->setRowCount(0);
-    auto members = librarySystem.getAllMembers();
     
-    auto allBooks = librarySystem.getAllBooks();
+    // Все фильтры сразу, по колонкам абонентов (подстроки - через триграммы)
+    MemberContainer::Query query;
+    query.name = memberFilters.name.toStdString();
+    query.surname = memberFilters.surname.toStdString();
+    query.phone = memberFilters.phone.toStdString();
+    query.email = memberFilters.email.toStdString();
+    query.blocked = memberFilters.blocked;
     
-    // Применяем все фильтры одновременно
-    for (const auto* member : members) {
-        bool matches = true;
-        
-        // Фильтр по имени
-        if (!memberFilters.name.isEmpty()) {
-            QString name = QString::fromStdString(member->getName()).toLower();
-            if (!name.contains(memberFilters.name.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по фамилии
-        if (matches && !memberFilters.surname.isEmpty()) {
-            QString surname = QString::fromStdString(member->getSurname()).toLower();
-            if (!surname.contains(memberFilters.surname.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по телефону
-        if (matches && !memberFilters.phone.isEmpty()) {
-            QString phone = QString::fromStdString(member->getPhone());
-            if (!phone.contains(memberFilters.phone)) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по email
-        if (matches && !memberFilters.email.isEmpty()) {
-            QString email = QString::fromStdString(member->getEmail()).toLower();
-            if (!email.contains(memberFilters.email.toLower())) {
-                matches = false;
-            }
-        }
-        
-        // Фильтр по статусу блокировки
-        if (matches && memberFilters.blocked != -1) {
-            bool isBlocked = member->getIsBlocked();
-            if ((memberFilters.blocked == 1 && !isBlocked) ||
-                (memberFilters.blocked == 0 && isBlocked)) {
-                matches = false;
-            }
-        }
-        
-        // Пропускаем абонента, если он не соответствует фильтрам
-        if (!matches) {
-            continue;
-        }
-        
+    for (const LibraryMember* member : librarySystem.findMembers(query)) {
         int row = membersTable->rowCount();
         membersTable->insertRow(row);
         
@@ -784,23 +707,18 @@ void MainWindow::refreshMembers()
         membersTable->setItem(row, 4, blockedItem);
         
         // Колонка 5 - Книги на руках
-        auto borrowedBooks = member->getBorrowedBooks();
-        int notReturnedCount = 0;
+        const LoanStore& loans = librarySystem.getLoanStore();
+        const auto& openLoanIds = loans.getMemberOpenLoans(member->getId());
+        auto notReturnedCount = static_cast<int>(openLoanIds.size());
         QStringList bookTitles;
         
-        for (const auto& borrowed : borrowedBooks) {
-            if (!borrowed.returned) {
-                notReturnedCount++;
-                // Находим название книги
-                QString bookTitle = QString::number(borrowed.bookId);
-                for (const auto* book : allBooks) {
-                    if (book->getId() == borrowed.bookId) {
-                        bookTitle = QString::fromStdString(book->getTitle());
-                        break;
-                    }
-                }
-                bookTitles << bookTitle;
+        for (const BorrowedBook& loan : loans.view(openLoanIds)) {
+            // Находим название книги
+            QString bookTitle = QString::number(loan.bookId);
+            if (const Book* book = librarySystem.findBook(loan.bookId)) {
+                bookTitle = QString::fromStdString(book->getTitle());
             }
+            bookTitles << bookTitle;
         }
         
         QString booksInfo;
@@ -835,7 +753,7 @@ void MainWindow::refreshMembers()
         infoBtn->setIcon(style()->standardIcon(QStyle::SP_MessageBoxInformation));
         infoBtn->setIconSize(QSize(22, 22));
         infoBtn->setToolTip("Информация об абоненте");
-        connect(infoBtn, &QPushButton::clicked, this, [this, member]() { onShowMemberDetails(member->getId()); });
+        connect(infoBtn, &QPushButton::clicked, this, [this, handle]() { if (const LibraryMember* member = librarySystem.resolveMember(handle)) { onShowMemberDetails(member->getId()); } });
         actionLayout->addWidget(infoBtn);
 
         // Кнопка "Редактировать"
@@ -843,7 +761,9 @@ void MainWindow::refreshMembers()
         editBtn->setIcon(style()->standardIcon(QStyle::SP_FileDialogContentsView));
         editBtn->setIconSize(QSize(22, 22));
         editBtn->setToolTip("Редактировать абонента");
-        connect(editBtn, &QPushButton::clicked, this, [this, member]() {
+        connect(editBtn, &QPushButton::clicked, this, [this, handle]() {
+            const LibraryMember* member = librarySystem.resolveMember(handle);
+            if (!member) return;
             if (auto* membersTableWidget = findChild<QTableWidget*>("membersTable"); membersTableWidget != nullptr) {
                 for (int r = 0; r < membersTableWidget->rowCount(); ++r) {
                     const auto* item = membersTableWidget->item(r, 0);
@@ -863,7 +783,9 @@ void MainWindow::refreshMembers()
         if (member->getIsBlocked()) {
             blockBtn->setIcon(style()->standardIcon(QStyle::SP_DialogResetButton));
             blockBtn->setToolTip("Разблокировать абонента");
-            connect(blockBtn, &QPushButton::clicked, this, [this, member]() {
+            connect(blockBtn, &QPushButton::clicked, this, [this, handle]() {
+                const LibraryMember* member = librarySystem.resolveMember(handle);
+                if (!member) return;
                 try {
                     librarySystem.unblockMember(member->getId());
                     refreshMembers();
@@ -877,7 +799,9 @@ void MainWindow::refreshMembers()
         } else {
             blockBtn->setIcon(style()->standardIcon(QStyle::SP_DialogCancelButton));
             blockBtn->setToolTip("Заблокировать абонента");
-            connect(blockBtn, &QPushButton::clicked, this, [this, member]() {
+            connect(blockBtn, &QPushButton::clicked, this, [this, handle]() {
+                const LibraryMember* member = librarySystem.resolveMember(handle);
+                if (!member) return;
                 try {
                     librarySystem.blockMember(member->getId());
                     refreshMembers();
@@ -896,7 +820,9 @@ void MainWindow::refreshMembers()
         delBtn->setIcon(createRedCrossIcon());
         delBtn->setIconSize(QSize(22, 22));
         delBtn->setToolTip("Удалить абонента");
-        connect(delBtn, &QPushButton::clicked, this, [this, member]() {
+        connect(delBtn, &QPushButton::clicked, this, [this, handle]() {
+            const LibraryMember* member = librarySystem.resolveMember(handle);
+            if (!member) return;
             int ret = QMessageBox::question(this, "Подтверждение удаления", QString("Вы уверены, что хотите удалить абонента %1?").arg(member->getId()), QMessageBox::Yes | QMessageBox::No);
             if (ret == QMessageBox::Yes) {
                 try {
@@ -923,9 +849,9 @@ void MainWindow::refreshEmployees()
     if (employeesTable == nullptr) return;
     
     employeesTable->setRowCount(0);
-    auto employees = librarySystem.getAllEmployees();
     
-    for (const auto* emp : employees) {
+    for (const Employee& empRef : librarySystem.getEmployees()) {
+        const Employee* emp = &empRef;
         int row = employeesTable->rowCount();
         employeesTable->insertRow(row);
         
@@ -1285,13 +1211,13 @@ void MainWindow::onEditBook()
     
     auto* availableCheckBox = new QCheckBox(&dialog);
     // Проверяем реальную доступность (с учетом количества и ручной блокировки)
-    int borrowedCount = librarySystem.getBorrowedCount(bookId);
-    int availableCount = bookPtr->getQuantity() - borrowedCount;
-    bool actuallyAvailable = !bookPtr->getManuallyDisabled() && availableCount > 0;
+    // Количество - экземпляры в наличии, всего - вместе с выданными
+    int availableCount = bookPtr->getQuantity();
+    bool actuallyAvailable = bookPtr->canBeBorrowed();
     availableCheckBox->setChecked(actuallyAvailable);
     // Добавляем подсказку о количестве
     auto* availabilityHint = new QLabel(&dialog);
-    availabilityHint->setText(QString("Доступно экземпляров: %1 из %2").arg(availableCount).arg(bookPtr->getQuantity()));
+    availabilityHint->setText(QString("Доступно экземпляров: %1 из %2").arg(availableCount).arg(bookPtr->getTotalCopies()));
     if (bookPtr->getManuallyDisabled()) {
         availabilityHint->setText(availabilityHint->text() + " (заблокировано вручную)");
     }
@@ -1687,49 +1613,17 @@ void MainWindow::onBorrowBook()
     QFormLayout form(&dialog);
 
     // Абонент с поиском
-    auto* memberCombo = new QComboBox(&dialog);
-    memberCombo->setEditable(true);
-    QStringList memberList;
-    auto members = librarySystem.getAllMembers();
-    for (const auto* member : members) {
-        QString memberText = QString("%1 %2").arg(QString::fromStdString(member->getName())).arg(QString::fromStdString(member->getSurname()));
-        memberCombo->addItem(memberText, member->getId());
-        memberList << memberText;
-    }
-    auto* memberCompleter = new QCompleter(memberList, memberCombo);
-    memberCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    memberCombo->setCompleter(memberCompleter);
-    form.addRow("Абонент:", memberCombo);
+    auto* memberField = createLookupField(&dialog, memberSuggestions());
+    form.addRow("Абонент:", memberField);
 
     // Книга с поиском
-    auto* bookCombo = new QComboBox(&dialog);
-    bookCombo->setEditable(true);
-    QStringList bookList;
-    auto books = librarySystem.getAllBooks();
-    for (const auto* book : books) {
-        QString bookText = QString::fromStdString(book->getTitle());
-        bookCombo->addItem(bookText, book->getId());
-        bookList << bookText;
-    }
-    auto* bookCompleter = new QCompleter(bookList, bookCombo);
-    bookCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    bookCombo->setCompleter(bookCompleter);
-    form.addRow("Книга:", bookCombo);
+    auto* bookField = createLookupField(&dialog, bookSuggestions());
+    form.addRow("Книга:", bookField);
 
     // Работник с поиском
-    auto* employeeCombo = new QComboBox(&dialog);
-    employeeCombo->setEditable(true);
-    QStringList employeeList;
-    auto employees = librarySystem.getAllEmployees();
-    for (const auto* emp : employees) {
-        QString empText = QString("%1 %2").arg(QString::fromStdString(emp->getName())).arg(QString::fromStdString(emp->getSurname()));
-        employeeCombo->addItem(empText, emp->getId());
-        employeeList << empText;
-    }
-    auto* empCompleter = new QCompleter(employeeList, employeeCombo);
-    empCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    employeeCombo->setCompleter(empCompleter);
-    form.addRow("Работник:", employeeCombo);
+    auto* employeeField = createLookupField(&dialog, employeeSuggestions());
+    setDefaultEmployee(employeeField);
+    form.addRow("Работник:", employeeField);
 
     QDialogButtonBox buttonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dialog);
     form.addRow(&buttonBox);
@@ -1739,9 +1633,13 @@ void MainWindow::onBorrowBook()
 
     if (dialog.exec() == QDialog::Accepted) {
         try {
-            int memberId = memberCombo->currentData().toInt();
-            int bookId = bookCombo->currentData().toInt();
-            int employeeId = employeeCombo->currentData().toInt();
+            int memberId = lookupId(memberField);
+            int bookId = lookupId(bookField);
+            int employeeId = std::max(lookupId(employeeField), 0);
+            if (memberId <= 0 || bookId <= 0) {
+                showError("Пожалуйста, выберите абонента и книгу");
+                return;
+            }
             librarySystem.borrowBook(memberId, bookId, employeeId);
             refreshBooks();
             refreshMembers();
@@ -1759,49 +1657,33 @@ void MainWindow::onReturnBook()
     dialog.setWindowTitle("Вернуть книгу");
     QFormLayout form(&dialog);
     
-    // Абонент с поиском
-    auto* memberCombo = new QComboBox(&dialog);
-    memberCombo->setEditable(true);
-    QStringList memberList;
-    auto members = librarySystem.getAllMembers();
-    for (const auto* member : members) {
-        QString memberText = QString("%1 %2").arg(QString::fromStdString(member->getName())).arg(QString::fromStdString(member->getSurname()));
-        memberCombo->addItem(memberText, member->getId());
-        memberList << memberText;
-    }
-    auto* memberCompleter = new QCompleter(memberList, memberCombo);
-    memberCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    memberCombo->setCompleter(memberCompleter);
-    form.addRow("Абонент:", memberCombo);
-    
     // Книга с поиском (только взятые книги выбранного абонента)
     auto* bookCombo = new QComboBox(&dialog);
     bookCombo->setEditable(true);
     bookCombo->setEnabled(false); // Будет активирован после выбора абонента
     
-    // Обновляем список книг при выборе абонента
-    connect(memberCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), [this, bookCombo, memberCombo]() {
+    // Абонент с поиском; при выборе абонента обновляется список книг
+    auto* memberField = createLookupField(&dialog, memberSuggestions(), [this, bookCombo](int memberId) {
         bookCombo->clear();
-        int memberId = memberCombo->currentData().toInt();
+        bookCombo->setEnabled(false);
         if (memberId > 0) {
             try {
-                auto borrowedBooks = librarySystem.getMemberBooks(memberId);
-                auto allBooks = librarySystem.getAllBooks();
+                const LibraryMember* member = librarySystem.findMember(memberId);
+                if (!member) {
+                    throw NotFoundException("Абонент с ID " + std::to_string(memberId));
+                }
                 QStringList bookList;
                 
-                for (const auto& borrowed : borrowedBooks) {
-                    if (!borrowed.returned) {
-                        // Находим название книги
-                        QString bookTitle = QString::number(borrowed.bookId);
-                        for (const auto* book : allBooks) {
-                            if (book->getId() == borrowed.bookId) {
-                                bookTitle = QString::fromStdString(book->getTitle());
-                                break;
-                            }
-                        }
-                        bookCombo->addItem(bookTitle, borrowed.bookId);
-                        bookList << bookTitle;
+                // Только книги на руках, без обхода всей истории
+                const LoanStore& loans = librarySystem.getLoanStore();
+                for (const BorrowedBook& loan : loans.view(loans.getMemberOpenLoans(member->getId()))) {
+                    // Находим название книги
+                    QString bookTitle = QString::number(loan.bookId);
+                    if (const Book* book = librarySystem.findBook(loan.bookId)) {
+                        bookTitle = QString::fromStdString(book->getTitle());
                     }
+                    bookCombo->addItem(bookTitle, loan.bookId);
+                    bookList << bookTitle;
                 }
                 
                 if (bookCombo->count() > 0) {
@@ -1819,7 +1701,7 @@ void MainWindow::onReturnBook()
             }
         }
     });
-    
+    form.addRow("Абонент:", memberField);
     form.addRow("Книга:", bookCombo);
     
     QDialogButtonBox buttonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel,
@@ -1831,7 +1713,7 @@ void MainWindow::onReturnBook()
     
     if (dialog.exec() == QDialog::Accepted) {
         try {
-            int memberId = memberCombo->currentData().toInt();
+            int memberId = lookupId(memberField);
             int bookId = bookCombo->currentData().toInt();
             
             if (memberId <= 0 || bookId <= 0) {
@@ -1885,30 +1767,29 @@ void MainWindow::onSearchMember()
     if (dialog.exec() == QDialog::Accepted) {
         try {
             std::vector<LibraryMember*> foundMembers;
-            auto allMembers = librarySystem.getAllMembers();
             
-            for (auto* member : allMembers) {
+            for (LibraryMember& member : librarySystem.getMembers()) {
                 bool match = true;
                 
                 if (!nameEdit->text().isEmpty() && 
-                    QString::fromStdString(member->getName()).toLower().indexOf(nameEdit->text().toLower()) == -1) {
+                    QString::fromStdString(member.getName()).indexOf(nameEdit->text(), 0, Qt::CaseInsensitive) == -1) {
                     match = false;
                 }
                 if (!surnameEdit->text().isEmpty() && 
-                    QString::fromStdString(member->getSurname()).toLower().indexOf(surnameEdit->text().toLower()) == -1) {
+                    QString::fromStdString(member.getSurname()).indexOf(surnameEdit->text(), 0, Qt::CaseInsensitive) == -1) {
                     match = false;
                 }
                 if (!phoneEdit->text().isEmpty() && 
-                    QString::fromStdString(member->getPhone()).indexOf(phoneEdit->text()) == -1) {
+                    QString::fromStdString(member.getPhone()).indexOf(phoneEdit->text()) == -1) {
                     match = false;
                 }
                 if (!emailEdit->text().isEmpty() && 
-                    QString::fromStdString(member->getEmail()).toLower().indexOf(emailEdit->text().toLower()) == -1) {
+                    QString::fromStdString(member.getEmail()).indexOf(emailEdit->text(), 0, Qt::CaseInsensitive) == -1) {
                     match = false;
                 }
                 
                 if (match) {
-                    foundMembers.push_back(member);
+                    foundMembers.push_back(&member);
                 }
             }
             
@@ -1954,9 +1835,7 @@ void MainWindow::onShowMemberDetails(int memberId)
             return;
         }
         
-        auto books = librarySystem.getMemberBooks(memberId);
-        auto allBooks = librarySystem.getAllBooks();
-        auto allEmployees = librarySystem.getAllEmployees();
+        auto books = librarySystem.getMemberLoans(memberId);
         
         // Создаем красивое окно с информацией
         auto* detailDialog = new QDialog(this);
@@ -2010,27 +1889,19 @@ void MainWindow::onShowMemberDetails(int memberId)
             
             // Находим название книги
             QString bookTitle = QString::number(borrowedBook.bookId);
-            for (const auto* b : allBooks) {
-                if (b->getId() == borrowedBook.bookId) {
-                    bookTitle = QString::fromStdString(b->getTitle());
-                    break;
-                }
+            if (const Book* b = librarySystem.findBook(borrowedBook.bookId)) {
+                bookTitle = QString::fromStdString(b->getTitle());
             }
             
             // Находим имя работника
             QString employeeName = "Неизвестно";
-            if (borrowedBook.employeeId > 0) {
-                for (const auto* emp : allEmployees) {
-                    if (emp->getId() == borrowedBook.employeeId) {
-                        employeeName = QString::fromStdString(emp->getFullName());
-                        break;
-                    }
-                }
+            if (const Employee* emp = librarySystem.findEmployee(borrowedBook.employeeId)) {
+                employeeName = QString::fromStdString(emp->getFullName());
             }
             
             booksTable->setItem(static_cast<int>(i), 0, new QTableWidgetItem(bookTitle));
-            booksTable->setItem(static_cast<int>(i), 1, new QTableWidgetItem(QString::fromStdString(borrowedBook.borrowDate)));
-            booksTable->setItem(static_cast<int>(i), 2, new QTableWidgetItem(QString::fromStdString(borrowedBook.returnDate)));
+            booksTable->setItem(static_cast<int>(i), 1, new QTableWidgetItem(QString::fromStdString(borrowedBook.borrowDate.toString())));
+            booksTable->setItem(static_cast<int>(i), 2, new QTableWidgetItem(QString::fromStdString(borrowedBook.returnDate.toString())));
             booksTable->setItem(static_cast<int>(i), 3, new QTableWidgetItem(borrowedBook.returned ? "Да" : "Нет"));
             booksTable->setItem(static_cast<int>(i), 4, new QTableWidgetItem(employeeName));
             
@@ -2082,8 +1953,8 @@ void MainWindow::onShowMemberDetails(int memberId)
 void MainWindow::onShowOverdueBooks()
 {
     try {
+        // Записи уже упорядочены по сроку возврата: самые давние просрочки первыми
         auto overdue = librarySystem.getOverdueBooks();
-        auto allBooks = librarySystem.getAllBooks();
         
         // Создаем простое диалоговое окно
         auto* overdueDialog = new QDialog(this);
@@ -2127,42 +1998,21 @@ void MainWindow::onShowOverdueBooks()
             overdueTable->setSelectionBehavior(QAbstractItemView::SelectRows);
             overdueTable->setAlternatingRowColors(true);
             
-            // Вычисляем количество дней просрочки и сортируем
-            QDate currentDate = QDate::currentDate();
-            QList<QPair<int, std::pair<const LibraryMember*, BorrowedBook>>> overdueWithDays;
-            
-            for (const auto& pair : overdue) {
-                const auto& book = pair.second;
-                
-                // Парсим дату возврата
-                QDate returnDate = QDate::fromString(QString::fromStdString(book.returnDate), "yyyy-MM-dd");
-                auto daysOverdue = static_cast<int>(returnDate.daysTo(currentDate));
-                
-                overdueWithDays.append({daysOverdue, pair});
-            }
-            
-            // Сортируем по количеству дней просрочки (по убыванию)
-            std::sort(overdueWithDays.begin(), overdueWithDays.end(),
-                     [](const QPair<int, std::pair<const LibraryMember*, BorrowedBook>>& a,
-                        const QPair<int, std::pair<const LibraryMember*, BorrowedBook>>& b) {
-                         return a.first > b.first;
-                     });
-            
-            overdueTable->setRowCount(static_cast<int>(overdueWithDays.size()));
+            Date currentDate = Date::today();
+            overdueTable->setRowCount(static_cast<int>(overdue.size()));
             
             // Заполняем таблицу
-            for (int i = 0; i < static_cast<int>(overdueWithDays.size()); ++i) { // NOSONAR - loop is safe, size is checked
-                const auto& [daysOverdue, memberBookPair] = overdueWithDays[i];
-                const LibraryMember* member = memberBookPair.first;
-                const BorrowedBook& book = memberBookPair.second;
+            for (int i = 0; i < static_cast<int>(overdue.size()); ++i) { // NOSONAR - loop is safe, size is checked
+                const LibraryMember* member = overdue[i].first;
+                const BorrowedBook& book = overdue[i].second;
+                
+                // Вычисляем количество дней просрочки
+                int daysOverdue = currentDate.toDays() - book.returnDate.toDays();
                 
                 // Находим название книги
                 QString bookTitle = QString("ID: %1").arg(book.bookId);
-                for (const auto* b : allBooks) {
-                    if (b->getId() == book.bookId) {
-                        bookTitle = QString::fromStdString(b->getTitle());
-                        break;
-                    }
+                if (const Book* b = librarySystem.findBook(book.bookId)) {
+                    bookTitle = QString::fromStdString(b->getTitle());
                 }
                 
                 // Заполняем строку
@@ -2177,10 +2027,10 @@ void MainWindow::onShowOverdueBooks()
                 auto* bookItem = new QTableWidgetItem(bookTitle);
                 overdueTable->setItem(i, 2, bookItem);
                 
-                auto* borrowDateItem = new QTableWidgetItem(QString::fromStdString(book.borrowDate));
+                auto* borrowDateItem = new QTableWidgetItem(QString::fromStdString(book.borrowDate.toString()));
                 overdueTable->setItem(i, 3, borrowDateItem);
                 
-                auto* returnDateItem = new QTableWidgetItem(QString::fromStdString(book.returnDate));
+                auto* returnDateItem = new QTableWidgetItem(QString::fromStdString(book.returnDate.toString()));
                 overdueTable->setItem(i, 4, returnDateItem);
                 
                 // Количество дней просрочки
@@ -2393,14 +2243,7 @@ void MainWindow::onEditEmployee()
     int employeeId = item->data(Qt::UserRole).toInt();
     if (employeeId <= 0) return;
     
-    const Employee* emp = nullptr;
-    for (const auto* e : librarySystem.getAllEmployees()) {
-        if (e->getId() == employeeId) {
-            emp = e;
-            break;
-        }
-    }
-    
+    const Employee* emp = librarySystem.findEmployee(employeeId);
     if (!emp) {
         showError("Работник не найден");
         return;
@@ -2660,7 +2503,7 @@ void MainWindow::onRedoEmployees()
 void MainWindow::onSave()
 {
     try {
-        FileManager::saveLibrarySystem(librarySystem, dataPath.toStdString());
+        saveNow();
         showInfo("Данные успешно сохранены");
     } catch (const CommandException& e) {
         showError(QString::fromStdString(e.what()));
@@ -2672,11 +2515,25 @@ void MainWindow::onSave()
 void MainWindow::onLoad()
 {
     try {
-        FileManager::loadLibrarySystem(librarySystem, dataPath.toStdString());
+        // Фоновая запись не должна идти одновременно с чтением файлов
+        saveNow();
+        // Файлы читаются в отдельную систему, которая заменяет текущую целиком: записи
+        // не смешиваются с уже загруженными, а при ошибке чтения данные остаются прежними
+        LibrarySystem loaded;
+        std::vector<std::string> problems = FileManager::loadLibrarySystem(loaded, dataPath.toStdString());
+        librarySystem = std::move(loaded);
+        librarySystem.setChangeListener(&changeTracker);
+        changeTracker.clear(); // Изменения из журнала уже в нём
+        changeTracker.markAllDirty(); // Записи загружены без уведомлений
         refreshBooks();
         refreshMembers();
         refreshEmployees();
-        showInfo("Данные успешно загружены");
+        updateUndoRedoButtons(); // История отмены относилась к прежним данным
+        if (problems.empty()) {
+            showInfo("Данные успешно загружены");
+        } else {
+            showLoadProblems(problems);
+        }
     } catch (const CommandException& e) {
         showError(QString::fromStdString(e.what()));
     } catch (const LibraryException& e) {
@@ -2684,6 +2541,60 @@ void MainWindow::onLoad()
     }
 }
 
+void MainWindow::onExportText()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "Каталог для экспорта");
+    if (directory.isEmpty()) {
+        return;
+    }
+    try {
+        FileManager::saveLibrarySystem(librarySystem, directory.toStdString());
+        showInfo("Данные выгружены в " + directory);
+    } catch (const LibraryException& e) {
+        showError(QString::fromStdString(e.what()));
+    }
+}
+
+void MainWindow::onImportText()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "Каталог с текстовыми файлами");
+    if (directory.isEmpty()) {
+        return;
+    }
+    try {
+        std::vector<std::string> problems = FileManager::importLibrarySystem(librarySystem, directory.toStdString());
+        // Импорт идёт без уведомлений об изменениях, поэтому сохраняется полной контрольной точкой
+        changeTracker.markAllDirty();
+        saveNow();
+        refreshBooks();
+        refreshMembers();
+        refreshEmployees();
+        if (problems.empty()) {
+            showInfo("Данные успешно импортированы");
+        } else {
+            showLoadProblems(problems);
+        }
+    } catch (const CommandException& e) {
+        showError(QString::fromStdString(e.what()));
+    } catch (const LibraryException& e) {
+        showError(QString::fromStdString(e.what()));
+    }
+}
+
+void MainWindow::showLoadProblems(const std::vector<std::string>& problems)
+{
+    // Показываем первые записи, чтобы окно не растягивалось на весь экран
+    const size_t maxShown = 20;
+    QString message = QString("Данные загружены, пропущено записей: %1\n").arg(problems.size());
+    for (size_t i = 0; i < problems.size() && i < maxShown; ++i) {
+        message += "\n" + QString::fromStdString(problems[i]);
+    }
+    if (problems.size() > maxShown) {
+        message += QString("\n... и еще %1").arg(problems.size() - maxShown);
+    }
+    QMessageBox::warning(this, "Предупреждение", message);
+}
+
 void MainWindow::showError(const QString& message)
 {
     QMessageBox::critical(this, "Ошибка", message);
@@ -2698,15 +2609,47 @@ void MainWindow::showInfo(const QString& message)
 
 void MainWindow::autoSave() const
 {
-    // Автоматическое сохранение без сообщений
-    try {
-        FileManager::saveLibrarySystem(librarySystem, dataPath.toStdString());
-    } catch (const FileException&) {
-        // Игнорируем ошибки автосохранения, чтобы не мешать работе пользователя
-        // Автосохранение выполняется в фоне, ошибки не критичны
+    // Запись откладывается: каждая новая правка перезапускает таймер,
+    // и серия быстрых действий сохраняется один раз
+    autoSaveTimer->start();
+}
+
+void MainWindow::submitAutoSave()
+{
+    // Пакет и снимок формируются здесь, в потоке интерфейса; на диск их пишет AutoSaver
+    if (autoSaver->needsCheckpoint() || autoSaver->journalSize() >= CHECKPOINT_JOURNAL_BYTES) {
+        // Журнал разросся или не записался - контрольная точка (изменённые сегменты) начинает его заново
+        changeTracker.clear();
+        autoSaver->submit(FileManager::captureSnapshot(librarySystem, changeTracker.takeDirty()));
+        return;
+    }
+    if (!changeTracker.empty()) {
+        autoSaver->append(FileManager::captureJournalBatch(librarySystem, changeTracker));
+        changeTracker.clear();
     }
 }
 
+void MainWindow::saveNow()
+{
+    autoSaveTimer->stop();
+    changeTracker.clear(); // Все изменения войдут в снимок
+    autoSaver->save(FileManager::captureSnapshot(librarySystem, changeTracker.takeDirty()));
+}
+
+void MainWindow::commitNow()
+{
+    autoSaveTimer->stop();
+    if (autoSaver->needsCheckpoint()) {
+        saveNow();
+        return;
+    }
+    if (!changeTracker.empty()) {
+        autoSaver->append(FileManager::captureJournalBatch(librarySystem, changeTracker));
+        changeTracker.clear();
+    }
+    autoSaver->sync();
+}
+
 void MainWindow::updateUndoRedoButtons() const
 {
     // Определяем текущую активную вкладку и обновляем кнопки соответственно
@@ -2801,11 +2744,14 @@ void MainWindow::loadDataSilently()
 {
     // Загружаем данные при старте, если они есть
     try {
-        FileManager::loadLibrarySystem(librarySystem, dataPath.toStdString());
+        std::vector<std::string> problems = FileManager::loadLibrarySystem(librarySystem, dataPath.toStdString());
         refreshBooks();
         refreshMembers();
         refreshEmployees();
         updateUndoRedoButtons();
+        if (!problems.empty()) {
+            showLoadProblems(problems);
+        }
     } catch (const FileException&) {
         // Игнорируем ошибки файлов при первой загрузке (файлы могут не существовать)
         // Это ожидаемое поведение при первом запуске приложения
@@ -2819,7 +2765,7 @@ void MainWindow::saveDataSilently() // NOSONAR - modifies librarySystem state
 {
     // Автоматически сохраняем данные при закрытии
     try {
-        FileManager::saveLibrarySystem(librarySystem, dataPath.toStdString());
+        commitNow();
     } catch (const FileException&) {
         // Игнорируем ошибки сохранения при закрытии
         // Приложение все равно будет закрыто, пользователь не может ничего сделать
@@ -2831,9 +2777,9 @@ void MainWindow::saveDataSilently() // NOSONAR - modifies librarySystem state
 
 void MainWindow::saveDataWithWarning()
 {
-    // Сохраняем данные перед закрытием
+    // Сохраняем данные перед закрытием, дожидаясь фоновой записи журнала
     try {
-        FileManager::saveLibrarySystem(librarySystem, dataPath.toStdString());
+        commitNow();
     } catch (const FileException& e) {
         QMessageBox::warning(this, "Предупреждение", 
                            QString("Не удалось сохранить данные: %1\n\nПриложение все равно будет закрыто.")
@@ -2985,6 +2931,95 @@ QComboBox* MainWindow::createComboBoxWithCompleter(QWidget* parent, const QStrin
     return combo;
 }
 
+QLineEdit* MainWindow::createLookupField(QWidget* parent, SuggestionModel::Source source, std::function<void(int)> onSelected) const
+{
+    auto* field = new QLineEdit(parent);
+    field->setPlaceholderText("Начните вводить...");
+    field->setProperty("lookupId", -1);
+    
+    // В модели только подсказки для текущего ввода: открытие диалога не зависит от размера базы
+    auto* model = new SuggestionModel(std::move(source), field);
+    auto* completer = new QCompleter(model, field);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion); // Отбор уже сделан индексом
+    
+    // Подключается до setCompleter, чтобы QCompleter видел уже новые подсказки
+    connect(field, &QLineEdit::textEdited, field, [field, model, completer, onSelected](const QString& text) {
+        model->setPrefix(text);
+        completer->complete();
+        if (field->property("lookupId").toInt() != -1) {
+            field->setProperty("lookupId", -1);
+            if (onSelected) onSelected(-1);
+        }
+    });
+    connect(completer, QOverload<const QModelIndex&>::of(&QCompleter::activated), field, [field, onSelected](const QModelIndex& index) {
+        int id = index.data(SuggestionModel::ID_ROLE).toInt();
+        field->setProperty("lookupId", id);
+        if (onSelected) onSelected(id);
+    });
+    field->setCompleter(completer);
+    
+    return field;
+}
+
+int MainWindow::lookupId(const QLineEdit* field)
+{
+    int id = field->property("lookupId").toInt();
+    if (id != -1) {
+        return id;
+    }
+    // Текст набран целиком, без выбора из списка
+    const QCompleter* completer = field->completer();
+    const auto* model = completer ? qobject_cast<const SuggestionModel*>(completer->model()) : nullptr;
+    return model ? model->findExact(field->text()) : -1;
+}
+
+void MainWindow::setLookupValue(QLineEdit* field, const QString& text, int id)
+{
+    field->setText(text);
+    field->setProperty("lookupId", id);
+}
+
+void MainWindow::setDefaultEmployee(QLineEdit* field) const
+{
+    const EmployeeContainer& employees = librarySystem.getEmployees();
+    if (auto it = employees.begin(); it != employees.end()) {
+        setLookupValue(field, QString("%1 %2").arg(QString::fromStdString(it->getName())).arg(QString::fromStdString(it->getSurname())), it->getId());
+    }
+}
+
+SuggestionModel::Source MainWindow::memberSuggestions() const
+{
+    return [this](const QString& prefix) {
+        std::vector<SuggestionModel::Item> items;
+        for (const LibraryMember* member : librarySystem.suggestMembers(prefix.toStdString(), SUGGESTION_LIMIT)) {
+            items.push_back({QString("%1 %2").arg(QString::fromStdString(member->getName())).arg(QString::fromStdString(member->getSurname())), member->getId()});
+        }
+        return items;
+    };
+}
+
+SuggestionModel::Source MainWindow::bookSuggestions() const
+{
+    return [this](const QString& prefix) {
+        std::vector<SuggestionModel::Item> items;
+        for (const Book* book : librarySystem.suggestBooks(prefix.toStdString(), SUGGESTION_LIMIT)) {
+            items.push_back({QString::fromStdString(book->getTitle()), book->getId()});
+        }
+        return items;
+    };
+}
+
+SuggestionModel::Source MainWindow::employeeSuggestions() const
+{
+    return [this](const QString& prefix) {
+        std::vector<SuggestionModel::Item> items;
+        for (const Employee* employee : librarySystem.suggestEmployees(prefix.toStdString(), SUGGESTION_LIMIT)) {
+            items.push_back({QString("%1 %2").arg(QString::fromStdString(employee->getName())).arg(QString::fromStdString(employee->getSurname())), employee->getId()});
+        }
+        return items;
+    };
+}
+
 void MainWindow::executeWithRefresh(std::function<void()> action, const QString& successMessage, const QString& errorContext)
 {
     try {
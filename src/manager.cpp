@@ -3,7 +3,12 @@
 
 Manager::Manager(int pId, std::string_view pName, std::string_view pSurname,
                  std::string_view pPhone, double pSalary, int pWorkHours)
-    : Employee(pId, pName, pSurname, pPhone, "Manager", pSalary, pWorkHours) {
+    : Employee(pId, pName, pSurname, pPhone, positionKey(), pSalary, pWorkHours) {
+}
+
+InternedString Manager::positionKey() {
+    static const InternedString key("Manager");
+    return key;
 }
 
 double Manager::calculateMonthlySalary() const {
@@ -0,0 +1,89 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Дескрипторы файла и отображения закрываются сразу: отображение остаётся
+// действительным до UnmapViewOfFile/munmap в деструкторе
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return;
+    }
+    opened = true;
+    if (size.QuadPart == 0) { // Пустой файл отобразить нельзя, да и не нужно
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        opened = false;
+        return;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        opened = false;
+        return;
+    }
+    data = static_cast<const char*>(view);
+    length = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return;
+    }
+    struct stat info;
+    if (::fstat(descriptor, &info) != 0) {
+        ::close(descriptor);
+        return;
+    }
+    opened = true;
+    if (info.st_size == 0) { // Пустой файл отобразить нельзя, да и не нужно
+        ::close(descriptor);
+        return;
+    }
+    void* view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (view == MAP_FAILED) {
+        opened = false;
+        return;
+    }
+    // Файл читается от начала до конца: ядро может подгружать страницы заранее
+    ::madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    data = static_cast<const char*>(view);
+    length = static_cast<size_t>(info.st_size);
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+}
+#endif
@@ -1,48 +1,189 @@
 #include "membercontainer.h"
+#include "catalogcolumns.h"
 #include "exceptions.h"
 
-void MemberContainer::addMember(std::unique_ptr<LibraryMember> member) {
-    if (findMember(member->getId()) != nullptr) {
+namespace {
+// Пустые слоты убираются, когда их больше половины (но не раньше этого порога)
+constexpr size_t MIN_HOLES_TO_COMPACT = 64;
+}
+
+void MemberContainer::link(SlabHandle handle) {
+    LibraryMember* member = storage.get(handle);
+    if (idIndex.contains(member->getId())) {
         throw DuplicateException("Абонент с ID " + std::to_string(member->getId()) + " уже существует");
     }
-    members.push_back(std::move(member));
+    idIndex.insert(member->getId(), members.size());
+    members.push_back({member, handle});
+    appendColumns(member);
+    nameIndex.set(member->getId(), member->getName() + " " + member->getSurname());
+}
+
+void MemberContainer::appendColumns(const LibraryMember* member) {
+    if (!member) {
+        names.appendEmpty();
+        surnames.appendEmpty();
+        phones.appendEmpty();
+        emails.appendEmpty();
+        return;
+    }
+    names.append(foldCase(member->getName()));
+    surnames.append(foldCase(member->getSurname()));
+    phones.append(member->getPhone());
+    emails.append(foldCase(member->getEmail()));
+}
+
+void MemberContainer::rebuildColumns() {
+    names.clear();
+    surnames.clear();
+    phones.clear();
+    emails.clear();
+    names.reserve(members.size());
+    surnames.reserve(members.size());
+    phones.reserve(members.size());
+    emails.reserve(members.size());
+    for (const Slot& slot : members) {
+        appendColumns(slot.member);
+    }
+}
+
+void MemberContainer::reserve(size_t count) {
+    storage.reserve(count);
+    members.reserve(count);
+}
+
+void MemberContainer::finishBulkLoad(std::vector<std::string>& problems) {
+    // В индексе пока только абоненты, бывшие до загрузки: они остаются первыми, загруженные - за ними
+    bulkStart = idIndex.size();
+    idIndex.clear();
+    std::vector<Slot> kept;
+    kept.reserve(members.size());
+    // Из повторяющихся записей остаётся первая, как если бы абоненты добавлялись через addMember
+    for (const Slot& slot : members) {
+        if (!slot.member) continue;
+        int id = slot.member->getId();
+        if (idIndex.contains(id)) {
+            problems.push_back("Абонент с ID " + std::to_string(id) + " встречается повторно, запись пропущена");
+            storage.erase(slot.handle);
+            continue;
+        }
+        idIndex.insert(id, kept.size());
+        kept.push_back(slot);
+    }
+    members.swap(kept);
+    holes = 0;
+    rebuildColumns();
+    std::vector<std::pair<int, std::string>> names;
+    names.reserve(members.size());
+    for (const Slot& slot : members) {
+        names.emplace_back(slot.member->getId(), slot.member->getName() + " " + slot.member->getSurname());
+    }
+    nameIndex.assign(names);
 }
 
 void MemberContainer::removeMember(int id) {
-    auto it = std::find_if(members.begin(), members.end(),
-                          [id](const std::unique_ptr<LibraryMember>& member) {
-                              return member->getId() == id;
-                          });
-    if (it != members.end()) {
-        members.erase(it);
-    } else {
+    size_t pos = idIndex.find(id);
+    if (pos == IdIndex::npos) {
         throw NotFoundException("Абонент с ID " + std::to_string(id));
     }
+    // Слот не сдвигается: остальные абоненты сохраняют позиции и порядок
+    storage.erase(members[pos].handle);
+    members[pos] = {nullptr, SlabHandle{}};
+    names.set(pos, std::string());
+    surnames.set(pos, std::string());
+    phones.set(pos, std::string());
+    emails.set(pos, std::string());
+    nameIndex.erase(id);
+    idIndex.erase(id);
+    ++holes;
+    if (holes >= MIN_HOLES_TO_COMPACT && holes * 2 > members.size()) {
+        compact();
+    }
 }
 
-LibraryMember* MemberContainer::findMember(int id) const {
-    auto it = std::find_if(members.begin(), members.end(),
-                          [id](const std::unique_ptr<LibraryMember>& member) {
-                              return member->getId() == id;
-                          });
-    return (it != members.end()) ? it->get() : nullptr;
+void MemberContainer::compact() {
+    auto newEnd = std::remove_if(members.begin(), members.end(), [](const Slot& slot) { return !slot.member; });
+    members.erase(newEnd, members.end());
+    holes = 0;
+    for (size_t i = 0; i < members.size(); ++i) {
+        idIndex.insert(members[i].member->getId(), i);
+    }
+    rebuildColumns();
+}
+
+void MemberContainer::syncMember(int id) {
+    size_t pos = idIndex.find(id);
+    if (pos == IdIndex::npos) {
+        return;
+    }
+    const LibraryMember* member = members[pos].member;
+    names.set(pos, foldCase(member->getName()));
+    surnames.set(pos, foldCase(member->getSurname()));
+    phones.set(pos, member->getPhone());
+    emails.set(pos, foldCase(member->getEmail()));
+    nameIndex.set(id, member->getName() + " " + member->getSurname());
+}
+
+std::vector<LibraryMember*> MemberContainer::suggestMembers(std::string_view prefix, size_t limit) const {
+    std::vector<LibraryMember*> result;
+    for (int id : nameIndex.find(prefix, limit)) {
+        result.push_back(findMember(id));
+    }
+    return result;
+}
+
+std::vector<LibraryMember*> MemberContainer::selectMembers(const Query& query) const {
+    using Word = SubstringColumn::Word;
+    constexpr size_t WORD_BITS = SubstringColumn::WORD_BITS;
+    std::vector<Word> mask((members.size() + WORD_BITS - 1) / WORD_BITS, 0);
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (members[i].member) {
+            mask[i / WORD_BITS] |= Word(1) << (i % WORD_BITS);
+        }
+    }
+
+    if (!query.name.empty()) {
+        names.filter(mask, foldCase(query.name));
+    }
+    if (!query.surname.empty()) {
+        surnames.filter(mask, foldCase(query.surname));
+    }
+    if (!query.phone.empty()) {
+        phones.filter(mask, query.phone);
+    }
+    if (!query.email.empty()) {
+        emails.filter(mask, foldCase(query.email));
+    }
+
+    std::vector<LibraryMember*> result;
+    for (size_t w = 0; w < mask.size(); ++w) {
+        for (Word bits = mask[w]; bits != 0; bits &= bits - 1) {
+            LibraryMember* member = members[w * WORD_BITS + lowestBit(bits)].member;
+            // Блокировка меняется без ведома контейнера - проверяется по самому абоненту
+            if (query.blocked == -1 || member->getIsBlocked() == (query.blocked == 1)) {
+                result.push_back(member);
+            }
+        }
+    }
+    return result;
 }
 
 std::vector<LibraryMember*> MemberContainer::getAllMembers() const {
     std::vector<LibraryMember*> result;
-    for (const auto& member : members) {
-        result.push_back(member.get());
+    result.reserve(size());
+    for (const auto& slot : members) {
+        if (slot.member) {
+            result.push_back(slot.member);
+        }
     }
     return result;
 }
 
 std::vector<LibraryMember*> MemberContainer::getBlockedMembers() const {
     std::vector<LibraryMember*> result;
-    for (const auto& member : members) {
-        if (member->getIsBlocked()) {
-            result.push_back(member.get());
+    for (const auto& slot : members) {
+        if (slot.member && slot.member->getIsBlocked()) {
+            result.push_back(slot.member);
         }
     }
     return result;
 }
-
@@ -0,0 +1,26 @@
+#include "overdueindex.h"
+
+namespace {
+constexpr LoanStore::LoanId MIN_ID = 0;
+constexpr LoanStore::LoanId MAX_ID = LoanStore::npos;
+}
+
+std::vector<OverdueIndex::Entry> OverdueIndex::getOverdue(Date date) const {
+    return std::vector<Entry>(entries.begin(), entries.upper_bound({date, MAX_ID}));
+}
+
+size_t OverdueIndex::countOverdue(Date date) const {
+    size_t count = 0;
+    for (auto it = entries.begin(); it != entries.end() && it->dueDate <= date; ++it) {
+        ++count;
+    }
+    return count;
+}
+
+std::vector<OverdueIndex::Entry> OverdueIndex::getDueBetween(Date from, Date to) const {
+    if (to < from) {
+        return {};
+    }
+    return std::vector<Entry>(entries.lower_bound({from, MIN_ID}),
+                              entries.upper_bound({to, MAX_ID}));
+}
@@ -6,6 +6,9 @@ Person::Person(int pId, std::string_view pName, std::string_view pSurname, std::
 }
 
 std::string Person::getFullName() const {
-    return getName() + " " + getSurname();
+    std::string fullName;
+    fullName.reserve(name.size() + 1 + surname.size());
+    fullName.append(name).append(" ").append(surname);
+    return fullName;
 }
 
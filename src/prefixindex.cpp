@@ -0,0 +1,55 @@
+#include "prefixindex.h"
+#include "catalogcolumns.h"
+#include <algorithm>
+#include <limits>
+
+void PrefixIndex::set(int id, std::string_view text) {
+    std::string key = foldCase(text);
+    auto current = byId.find(id);
+    if (current != byId.end()) {
+        if (current->second->first == key) {
+            return;
+        }
+        entries.erase(current->second);
+    }
+    byId[id] = entries.emplace(std::move(key), id).first;
+}
+
+void PrefixIndex::erase(int id) {
+    auto current = byId.find(id);
+    if (current != byId.end()) {
+        entries.erase(current->second);
+        byId.erase(current);
+    }
+}
+
+void PrefixIndex::assign(const std::vector<std::pair<int, std::string>>& items) {
+    clear();
+    std::vector<std::pair<std::string, int>> sorted;
+    sorted.reserve(items.size());
+    for (const auto& [id, text] : items) {
+        sorted.emplace_back(foldCase(text), id);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    // Вставка по порядку в конец - без поиска места для каждого ключа
+    byId.reserve(sorted.size());
+    for (auto& item : sorted) {
+        int id = item.second;
+        byId[id] = entries.emplace_hint(entries.end(), std::move(item));
+    }
+}
+
+void PrefixIndex::clear() {
+    entries.clear();
+    byId.clear();
+}
+
+std::vector<int> PrefixIndex::find(std::string_view prefix, size_t limit) const {
+    std::string key = foldCase(prefix);
+    std::vector<int> result;
+    for (auto it = entries.lower_bound({key, std::numeric_limits<int>::min()});
+         it != entries.end() && result.size() < limit && it->first.compare(0, key.size(), key) == 0; ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
@@ -0,0 +1,136 @@
+#include "substringcolumn.h"
+#include <algorithm>
+
+namespace {
+std::uint32_t trigramAt(std::string_view text, size_t pos) {
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(text[pos])) << 16) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8) |
+           static_cast<unsigned char>(text[pos + 2]);
+}
+}
+
+void SubstringColumn::link(size_t row, std::string_view value) {
+    auto number = static_cast<std::uint32_t>(row);
+    for (size_t pos = 0; pos + 3 <= value.size(); ++pos) {
+        Postings& rows = trigrams[trigramAt(value, pos)];
+        // Новые строки - в конце колонки, так что обычно это добавление в конец списка
+        if (rows.empty() || rows.back() < number) {
+            rows.push_back(number);
+            continue;
+        }
+        auto it = std::lower_bound(rows.begin(), rows.end(), number);
+        if (*it != number) { // Триграмма может повторяться в одном значении
+            rows.insert(it, number);
+        }
+    }
+}
+
+void SubstringColumn::unlink(size_t row, std::string_view value) {
+    auto number = static_cast<std::uint32_t>(row);
+    for (size_t pos = 0; pos + 3 <= value.size(); ++pos) {
+        auto trigram = trigrams.find(trigramAt(value, pos));
+        if (trigram == trigrams.end()) {
+            continue; // Уже снята раньше в этом же значении
+        }
+        Postings& rows = trigram->second;
+        auto it = std::lower_bound(rows.begin(), rows.end(), number);
+        if (it != rows.end() && *it == number) {
+            rows.erase(it);
+        }
+        if (rows.empty()) {
+            trigrams.erase(trigram);
+        }
+    }
+}
+
+void SubstringColumn::append(std::string value) {
+    link(values.size(), value);
+    values.push_back(std::move(value));
+}
+
+void SubstringColumn::appendEmpty() {
+    values.emplace_back();
+}
+
+void SubstringColumn::set(size_t row, std::string value) {
+    if (values[row] == value) {
+        return;
+    }
+    unlink(row, values[row]);
+    link(row, value);
+    values[row] = std::move(value);
+}
+
+void SubstringColumn::clear() {
+    values.clear();
+    trigrams.clear();
+}
+
+void SubstringColumn::reserve(size_t count) {
+    values.reserve(count);
+}
+
+bool SubstringColumn::filterTrigrams(std::vector<Word>& mask, std::string_view needle) const {
+    std::vector<const Postings*> lists;
+    for (size_t pos = 0; pos + 3 <= needle.size(); ++pos) {
+        auto trigram = trigrams.find(trigramAt(needle, pos));
+        if (trigram == trigrams.end()) {
+            std::fill(mask.begin(), mask.end(), 0);
+            return true;
+        }
+        lists.push_back(&trigram->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const Postings* left, const Postings* right) { return left->size() < right->size(); });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+    // Если триграмма есть почти везде, пересечение списков дороже проверки подряд
+    if (lists.front()->size() > values.size() / 4) {
+        return false;
+    }
+
+    // Кандидаты - из самого короткого списка, среди уже отмеченных строк;
+    // остальные списки только сокращают их (двоичным поиском)
+    Postings candidates;
+    for (std::uint32_t row : *lists.front()) {
+        if ((mask[row / WORD_BITS] >> (row % WORD_BITS)) & 1) {
+            candidates.push_back(row);
+        }
+    }
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        auto from = lists[i]->begin();
+        auto kept = candidates.begin();
+        for (std::uint32_t row : candidates) {
+            from = std::lower_bound(from, lists[i]->end(), row);
+            if (from == lists[i]->end()) {
+                break;
+            }
+            if (*from == row) {
+                *kept++ = row;
+            }
+        }
+        candidates.erase(kept, candidates.end());
+    }
+
+    std::fill(mask.begin(), mask.end(), 0);
+    for (std::uint32_t row : candidates) {
+        mask[row / WORD_BITS] |= Word(1) << (row % WORD_BITS);
+    }
+    return true;
+}
+
+void SubstringColumn::filter(std::vector<Word>& mask, std::string_view needle) const {
+    if (needle.size() >= 3 && filterTrigrams(mask, needle) && needle.size() == 3) {
+        return; // Совпадение триграммы и есть совпадение подстроки
+    }
+
+    for (size_t w = 0; w < mask.size(); ++w) {
+        Word bits = mask[w];
+        while (bits != 0) {
+            Word lowest = bits & (~bits + 1);
+            size_t row = w * WORD_BITS + lowestBit(bits);
+            if (values[row].find(needle) == std::string::npos) {
+                mask[w] &= ~lowest;
+            }
+            bits &= bits - 1;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#include "../include/suggestionmodel.h"
+
+SuggestionModel::SuggestionModel(Source pSource, QObject* parent)
+    : QAbstractListModel(parent), source(std::move(pSource)) {}
+
+int SuggestionModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(items.size());
+}
+
+QVariant SuggestionModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= static_cast<int>(items.size())) {
+        return {};
+    }
+    const Item& item = items[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return item.text;
+    }
+    if (role == ID_ROLE) {
+        return item.id;
+    }
+    return {};
+}
+
+void SuggestionModel::setPrefix(const QString& prefix)
+{
+    beginResetModel();
+    items = source(prefix);
+    endResetModel();
+}
+
+int SuggestionModel::findExact(const QString& text) const
+{
+    for (const Item& item : items) {
+        if (item.text.compare(text.trimmed(), Qt::CaseInsensitive) == 0) {
+            return item.id;
+        }
+    }
+    return -1;
+}
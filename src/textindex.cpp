@@ -0,0 +1,243 @@
+#include "textindex.h"
+#include "catalogcolumns.h"
+#include <algorithm>
+
+namespace {
+// Буквы и цифры, из которых состоят слова: латиница (в т.ч. с диакритикой) и кириллица.
+// Остальное - пробелы, знаки препинания, кавычки, тире - разделяет слова
+size_t wordCharLength(std::string_view text, size_t i) {
+    auto c = static_cast<unsigned char>(text[i]);
+    if (c < 0x80) {
+        bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        return alnum ? 1 : 0;
+    }
+    if ((c & 0xE0) != 0xC0 || i + 1 >= text.size()) {
+        return 0;
+    }
+    char32_t letter = (static_cast<char32_t>(c & 0x1F) << 6) | (static_cast<unsigned char>(text[i + 1]) & 0x3F);
+    bool latin = letter >= 0xC0 && letter <= 0x24F && letter != 0xD7 && letter != 0xF7;
+    bool cyrillic = letter >= 0x400 && letter <= 0x4FF;
+    return (latin || cyrillic) ? 2 : 0;
+}
+
+size_t otherCharLength(std::string_view text, size_t i) {
+    auto c = static_cast<unsigned char>(text[i]);
+    size_t length = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+    return std::min(length, text.size() - i);
+}
+
+void addWord(std::string_view word, std::vector<std::string>& tokens) {
+    std::string token = foldCase(word);
+    // "ё" и "е" в запросах обычно не различают
+    for (size_t pos = token.find("\xD1\x91"); pos != std::string::npos; pos = token.find("\xD1\x91", pos)) {
+        token.replace(pos, 2, "\xD0\xB5");
+    }
+    tokens.push_back(std::move(token));
+}
+
+void appendWords(std::string_view text, std::vector<std::string>& tokens) {
+    size_t start = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        if (size_t length = wordCharLength(text, i); length > 0) {
+            i += length;
+            continue;
+        }
+        if (i > start) {
+            addWord(text.substr(start, i - start), tokens);
+        }
+        i += otherCharLength(text, i);
+        start = i;
+    }
+    if (i > start) {
+        addWord(text.substr(start, i - start), tokens);
+    }
+}
+
+// Пересечение отсортированных списков: кандидаты из result ищутся в list двоичным поиском
+void intersect(std::vector<std::uint32_t>& result, const std::vector<std::uint32_t>& list) {
+    auto from = list.begin();
+    auto kept = result.begin();
+    for (std::uint32_t row : result) {
+        from = std::lower_bound(from, list.end(), row);
+        if (from == list.end()) {
+            break;
+        }
+        if (*from == row) {
+            *kept++ = row;
+        }
+    }
+    result.erase(kept, result.end());
+}
+
+bool wordLess(const std::pair<const std::string, std::vector<std::uint32_t>>* left, std::string_view right) {
+    return left->first < right;
+}
+}
+
+void TextIndex::tokenize(std::string_view text, std::vector<std::string>& tokens) {
+    tokens.clear();
+    appendWords(text, tokens);
+}
+
+void TextIndex::tokenize(const Book& book, std::vector<std::string>& tokens) {
+    tokens.clear();
+    appendWords(book.getTitle(), tokens);
+    appendWords(book.getAuthor(), tokens);
+    appendWords(book.getGenre(), tokens);
+    appendWords(book.getDescription(), tokens);
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+}
+
+void TextIndex::link(size_t row, const std::vector<std::string>& tokens) {
+    auto value = static_cast<std::uint32_t>(row);
+    std::vector<Entry*>& linked = rowWords[row];
+    linked.reserve(linked.size() + tokens.size());
+    for (const std::string& token : tokens) {
+        auto [it, inserted] = words.try_emplace(token);
+        Entry* word = &*it;
+        if (inserted && sorted) {
+            sortedWords.insert(std::lower_bound(sortedWords.begin(), sortedWords.end(), token, wordLess), word);
+        }
+        Postings& rows = word->second;
+        // Новые книги получают последнюю строку - обычно это просто добавление в конец
+        if (rows.empty() || rows.back() < value) {
+            rows.push_back(value);
+        } else {
+            rows.insert(std::lower_bound(rows.begin(), rows.end(), value), value);
+        }
+        linked.push_back(word);
+    }
+}
+
+void TextIndex::unlink(size_t row, Entry* word) {
+    Postings& rows = word->second;
+    auto it = std::lower_bound(rows.begin(), rows.end(), static_cast<std::uint32_t>(row));
+    if (it != rows.end() && *it == row) {
+        rows.erase(it);
+    }
+    if (!rows.empty()) {
+        return;
+    }
+    if (sorted) {
+        sortedWords.erase(std::lower_bound(sortedWords.begin(), sortedWords.end(), word->first, wordLess));
+    }
+    words.erase(words.find(word->first));
+}
+
+void TextIndex::append(const Book& book) {
+    appendEmpty();
+    update(rowWords.size() - 1, book);
+}
+
+void TextIndex::appendEmpty() {
+    rowWords.emplace_back();
+}
+
+void TextIndex::update(size_t row, const Book& book) {
+    std::vector<std::string> tokens;
+    tokenize(book, tokens);
+
+    // Меняются только списки слов, которые появились или пропали (обычно - ни одного)
+    std::vector<Entry*>& linked = rowWords[row];
+    std::vector<std::string> added;
+    std::vector<Entry*> kept;
+    kept.reserve(linked.size());
+    for (Entry* word : linked) {
+        if (std::binary_search(tokens.begin(), tokens.end(), word->first)) {
+            kept.push_back(word);
+        } else {
+            unlink(row, word);
+        }
+    }
+    for (std::string& token : tokens) {
+        bool present = std::any_of(kept.begin(), kept.end(), [&token](const Entry* word) { return word->first == token; });
+        if (!present) {
+            added.push_back(std::move(token));
+        }
+    }
+    linked = std::move(kept);
+    link(row, added);
+}
+
+void TextIndex::erase(size_t row) {
+    for (Entry* word : rowWords[row]) {
+        unlink(row, word);
+    }
+    rowWords[row].clear();
+    rowWords[row].shrink_to_fit();
+}
+
+void TextIndex::clear() {
+    words.clear();
+    rowWords.clear();
+    sortedWords.clear();
+    sortedWords.shrink_to_fit();
+    sorted = false;
+}
+
+void TextIndex::reserve(size_t count) {
+    rowWords.reserve(count);
+    words.reserve(count); // Различных слов обычно не меньше, чем книг: без повторных перехеширований
+}
+
+const std::vector<const TextIndex::Entry*>& TextIndex::alphabet() const {
+    if (!sorted) {
+        sortedWords.reserve(words.size());
+        for (const Entry& word : words) {
+            sortedWords.push_back(&word);
+        }
+        std::sort(sortedWords.begin(), sortedWords.end(), [](const Entry* left, const Entry* right) { return left->first < right->first; });
+        sorted = true;
+    }
+    return sortedWords;
+}
+
+std::vector<size_t> TextIndex::search(const std::vector<std::string>& query) const {
+    std::vector<size_t> result;
+    if (query.empty()) {
+        return result;
+    }
+
+    // Полные слова - точное совпадение
+    std::vector<const Postings*> lists;
+    for (size_t i = 0; i + 1 < query.size(); ++i) {
+        auto word = words.find(query[i]);
+        if (word == words.end()) {
+            return result;
+        }
+        lists.push_back(&word->second);
+    }
+
+    // Последнее слово, возможно, ещё набирается: объединение списков всех слов с таким началом
+    const std::string& prefix = query.back();
+    Postings prefixed;
+    const Postings* prefixList = nullptr;
+    size_t matched = 0;
+    const std::vector<const Entry*>& sortedList = alphabet();
+    for (auto word = std::lower_bound(sortedList.begin(), sortedList.end(), prefix, wordLess);
+         word != sortedList.end() && (*word)->first.compare(0, prefix.size(), prefix) == 0; ++word) {
+        prefixList = &(*word)->second;
+        prefixed.insert(prefixed.end(), prefixList->begin(), prefixList->end());
+        ++matched;
+    }
+    if (matched == 0) {
+        return result;
+    }
+    if (matched > 1) {
+        std::sort(prefixed.begin(), prefixed.end());
+        prefixed.erase(std::unique(prefixed.begin(), prefixed.end()), prefixed.end());
+        prefixList = &prefixed;
+    }
+    lists.push_back(prefixList);
+
+    // С самого короткого списка: дальше кандидатов только меньше
+    std::sort(lists.begin(), lists.end(), [](const Postings* left, const Postings* right) { return left->size() < right->size(); });
+    Postings rows = *lists.front();
+    for (size_t i = 1; i < lists.size() && !rows.empty(); ++i) {
+        intersect(rows, *lists[i]);
+    }
+    result.assign(rows.begin(), rows.end());
+    return result;
+}